@@ -1,150 +1,243 @@
 #include <juce_graphics/juce_graphics.h>
 #include <juce_core/juce_core.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
-
-juce::Image createBlurredGradient(int size, const juce::Colour& color, int blurRadius)
+#include "Source/GlowAssetPack.h"
+#include "Source/GlowRasterizer.h"
+
+// Renders the glow layers for all 3 presets.
+//
+//   GenerateAllPresetImages --pack <file> writes the alpha-mask pack the build embeds
+//   GenerateAllPresetImages --check       compares the layers with the 2D kernel
+//
+// Layers are rendered in parallel, each with GlowRasterizer's separable blur.
+// --check also renders every layer with the 2D juce::ImageConvolutionKernel the
+// generator used to use (seconds per layer rather than milliseconds) and
+// reports the largest channel difference from it.
+
+struct PresetConfig
 {
-    int imageSize = size + blurRadius * 2;
-    juce::Image img(juce::Image::ARGB, imageSize, imageSize, true);
+    const char* name;
+    juce::Colour colors[GlowRasterizer::numLayers];
+    int sizes[GlowRasterizer::numLayers];
+};
 
-    juce::Graphics g(img);
+static const PresetConfig presets[] = {
+    // Blue preset
+    {
+        "blue",
+        {
+            juce::Colour::fromFloatRGBA(0.0f, 0.55f, 1.0f, 0.95f),
+            juce::Colour::fromFloatRGBA(0.0f, 0.57f, 1.0f, 0.75f),
+            juce::Colour::fromFloatRGBA(0.04f, 0.59f, 1.0f, 0.60f),
+            juce::Colour::fromFloatRGBA(0.12f, 0.63f, 1.0f, 0.45f),
+            juce::Colour::fromFloatRGBA(0.20f, 0.69f, 1.0f, 0.35f)
+        },
+        { 120, 180, 260, 360, 480 }
+    },
+    // Red preset
+    {
+        "red",
+        {
+            juce::Colour::fromFloatRGBA(1.0f, 0.27f, 0.23f, 0.95f),
+            juce::Colour::fromFloatRGBA(1.0f, 0.29f, 0.25f, 0.75f),
+            juce::Colour::fromFloatRGBA(1.0f, 0.33f, 0.29f, 0.60f),
+            juce::Colour::fromFloatRGBA(1.0f, 0.39f, 0.35f, 0.45f),
+            juce::Colour::fromFloatRGBA(1.0f, 0.47f, 0.43f, 0.35f)
+        },
+        { 120, 180, 260, 360, 480 }
+    },
+    // Black preset (white glow, smaller for visual balance)
+    {
+        "black",
+        {
+            juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.95f),
+            juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.75f),
+            juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.60f),
+            juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.45f),
+            juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.35f)
+        },
+        { 100, 150, 215, 300, 400 }
+    }
+};
 
-    float centerX = imageSize / 2.0f;
-    float centerY = imageSize / 2.0f;
-    float radius = size / 2.0f;
+// Runs job(0) .. job(numJobs - 1) on a pool with a thread per core and waits for them all
+template <typename Job>
+static void runInParallel(int numJobs, Job&& job)
+{
+    std::atomic<int> remaining { numJobs };
+    juce::WaitableEvent finished;
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName("Glow generator") };
 
-    juce::ColourGradient gradient(
-        color,
-        centerX, centerY,
-        color.withAlpha(0.0f),
-        centerX + radius, centerY,
-        true
-    );
+    for (int i = 0; i < numJobs; ++i)
+    {
+        pool.addJob([&, i]
+        {
+            job(i);
 
-    gradient.addColour(0.3, color.withMultipliedAlpha(0.9f));
-    gradient.addColour(0.5, color.withMultipliedAlpha(0.6f));
-    gradient.addColour(0.7, color.withMultipliedAlpha(0.3f));
-    gradient.addColour(0.9, color.withMultipliedAlpha(0.1f));
+            if (--remaining == 0)
+                finished.signal();
+        });
+    }
 
-    g.setGradientFill(gradient);
-    g.fillEllipse(centerX - radius, centerY - radius, radius * 2, radius * 2);
+    if (numJobs > 0)
+        finished.wait();
+}
 
-    if (blurRadius > 0)
-    {
-        juce::ImageConvolutionKernel blur(blurRadius);
-        blur.createGaussianBlur(blurRadius * 0.4f);
-        blur.applyToImage(img, img, juce::Rectangle<int>(0, 0, imageSize, imageSize));
-    }
+// The old way: the full 2D kernel, O(blurRadius²) per pixel
+static juce::Image renderWithConvolutionKernel(int size, juce::Colour colour, int blurRadius)
+{
+    auto image = GlowRasterizer::renderGradient(size, colour, blurRadius);
 
-    return img;
+    juce::ImageConvolutionKernel blur(blurRadius);
+    blur.createGaussianBlur(blurRadius * 0.4f);
+    blur.applyToImage(image, image, image.getBounds());
+
+    return image;
 }
 
-int main(int argc, char* argv[])
+static int getMaxChannelDifference(const juce::Image& a, const juce::Image& b)
 {
-    juce::initialiseJuce_GUI();
+    const juce::Image::BitmapData dataA(a, juce::Image::BitmapData::readOnly);
+    const juce::Image::BitmapData dataB(b, juce::Image::BitmapData::readOnly);
+    int maxDifference = 0;
 
-    std::cout << "Generating glow images for all 3 presets...\n\n";
+    for (int y = 0; y < dataA.height; ++y)
+        for (int i = 0; i < dataA.width * dataA.pixelStride; ++i)
+            maxDifference = juce::jmax(maxDifference, std::abs((int)dataA.getLinePointer(y)[i]
+                                                               - (int)dataB.getLinePointer(y)[i]));
 
-    struct PresetConfig {
-        const char* name;
-        juce::Colour colors[5];
-        int sizes[5];
-    };
+    return maxDifference;
+}
 
-    // Standard sizes for blue and red presets
-    int sizes[] = {120, 180, 260, 360, 480};
-    
-    // Smaller sizes for black preset (white glow needs to be smaller for visual balance)
-    int blackPresetSizes[] = {100, 150, 215, 300, 400};
+// The pad tints the layers with its theme colours, so the pack holds one alpha
+// mask per layer and glow size (see GlowAssetPack). Run by the build; see CMakeLists.txt.
+static int packGlowLayers(const juce::File& outputFile)
+{
+    std::vector<GlowAssetPack::SourceImage> images;
 
-    PresetConfig presets[] = {
-        // Blue preset
-        {
-            "blue",
-            {
-                juce::Colour::fromFloatRGBA(0.0f, 0.55f, 1.0f, 0.95f),
-                juce::Colour::fromFloatRGBA(0.0f, 0.57f, 1.0f, 0.75f),
-                juce::Colour::fromFloatRGBA(0.04f, 0.59f, 1.0f, 0.60f),
-                juce::Colour::fromFloatRGBA(0.12f, 0.63f, 1.0f, 0.45f),
-                juce::Colour::fromFloatRGBA(0.20f, 0.69f, 1.0f, 0.35f)
-            },
-            {}  // Will be filled below
-        },
-        // Red preset
-        {
-            "red",
-            {
-                juce::Colour::fromFloatRGBA(1.0f, 0.27f, 0.23f, 0.95f),
-                juce::Colour::fromFloatRGBA(1.0f, 0.29f, 0.25f, 0.75f),
-                juce::Colour::fromFloatRGBA(1.0f, 0.33f, 0.29f, 0.60f),
-                juce::Colour::fromFloatRGBA(1.0f, 0.39f, 0.35f, 0.45f),
-                juce::Colour::fromFloatRGBA(1.0f, 0.47f, 0.43f, 0.35f)
-            },
-            {}  // Will be filled below
-        },
-        // Black preset (white glow)
+    for (auto& preset : presets)
+    {
+        for (int i = 0; i < GlowRasterizer::numLayers; ++i)
         {
-            "black",
+            auto alreadyListed = std::any_of(images.begin(), images.end(), [&](auto& image)
             {
-                juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.95f),
-                juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.75f),
-                juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.60f),
-                juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.45f),
-                juce::Colour::fromFloatRGBA(1.0f, 1.0f, 1.0f, 0.35f)
-            },
-            {}  // Will be filled below
-        }
-    };
+                return image.layer == i && image.glowSize == preset.sizes[i];
+            });
 
-    // Fill in sizes for each preset
-    for (int p = 0; p < 3; ++p) {
-        int* currentSizes = (p == 2) ? blackPresetSizes : sizes;  // Use smaller sizes for black preset
-        for (int i = 0; i < 5; ++i) {
-            presets[p].sizes[i] = currentSizes[i];
+            if (!alreadyListed)
+                images.push_back({ i, preset.sizes[i], {}, GlowAssetPack::Format::alphaMask });
         }
     }
 
-    juce::File resourcesDir = juce::File::getCurrentWorkingDirectory().getChildFile("Resources");
-    if (!resourcesDir.exists())
-        resourcesDir.createDirectory();
+    auto start = juce::Time::getMillisecondCounterHiRes();
 
-    int blurRadii[] = {15, 20, 30, 40, 50};
+    runInParallel((int)images.size(), [&](int n)
+    {
+        auto& image = images[(size_t)n];
+        image.image = GlowRasterizer::renderGlowMask(image.glowSize, GlowRasterizer::layerOpacities[image.layer],
+                                                     GlowRasterizer::layerBlurRadii[image.layer]);
+    });
+
+    auto elapsed = juce::Time::getMillisecondCounterHiRes() - start;
+
+    outputFile.getParentDirectory().createDirectory();
+    juce::TemporaryFile temp(outputFile);
 
-    for (int p = 0; p < 3; ++p)
     {
-        std::cout << "=== Preset: " << presets[p].name << " ===\n";
+        juce::FileOutputStream stream(temp.getFile());
 
-        for (int i = 0; i < 5; ++i)
+        if (!stream.openedOk() || !GlowAssetPack::write(images, stream))
         {
-            auto start = juce::Time::getMillisecondCounter();
-            std::cout << "  Layer " << i << " (size=" << presets[p].sizes[i]
-                      << ", blur=" << blurRadii[i] << ")..." << std::flush;
+            std::cerr << "Couldn't write " << outputFile.getFullPathName() << "\n";
+            return 1;
+        }
+    }
 
-            juce::Image img = createBlurredGradient(presets[p].sizes[i], presets[p].colors[i], blurRadii[i]);
+    if (!temp.overwriteTargetFileWithTemporary())
+    {
+        std::cerr << "Couldn't replace " << outputFile.getFullPathName() << "\n";
+        return 1;
+    }
 
-            juce::String filename = juce::String("glow_") + presets[p].name + "_layer_" + juce::String(i) + ".png";
-            juce::File outputFile = resourcesDir.getChildFile(filename);
-            juce::FileOutputStream stream(outputFile);
+    std::cout << "Rendered " << images.size() << " glow masks in " << juce::roundToInt(elapsed) << "ms and packed them into "
+              << outputFile.getFullPathName() << " (" << outputFile.getSize() / 1024 << " KB)\n";
+    return 0;
+}
 
-            if (stream.openedOk())
-            {
-                juce::PNGImageFormat pngFormat;
-                pngFormat.writeImageToStream(img, stream);
+static int checkAgainstConvolutionKernel()
+{
+    struct LayerResult
+    {
+        double milliseconds = 0;
+        int maxError = 0;
+    };
 
-                auto elapsed = juce::Time::getMillisecondCounter() - start;
-                std::cout << " done (" << elapsed << "ms)\n";
-            }
-            else
-            {
-                std::cout << " FAILED to write file!\n";
-                return 1;
-            }
-        }
-        std::cout << "\n";
+    const int numPresets = (int)std::size(presets);
+    const int numJobs = numPresets * GlowRasterizer::numLayers;
+    std::vector<LayerResult> results((size_t)numJobs);
+
+    std::cout << "Checking the glow layers of all " << numPresets << " presets...\n\n";
+
+    runInParallel(numJobs, [&](int n)
+    {
+        auto& preset = presets[n / GlowRasterizer::numLayers];
+        auto i = n % GlowRasterizer::numLayers;
+        auto& result = results[(size_t)n];
+
+        auto layerStart = juce::Time::getMillisecondCounterHiRes();
+        auto image = GlowRasterizer::renderGlow(preset.sizes[i], preset.colors[i], GlowRasterizer::layerBlurRadii[i]);
+        result.milliseconds = juce::Time::getMillisecondCounterHiRes() - layerStart;
+
+        result.maxError = getMaxChannelDifference(image, renderWithConvolutionKernel(preset.sizes[i], preset.colors[i],
+                                                                                     GlowRasterizer::layerBlurRadii[i]));
+    });
+
+    int maxError = 0;
+
+    for (int n = 0; n < numJobs; ++n)
+    {
+        auto& preset = presets[n / GlowRasterizer::numLayers];
+        auto i = n % GlowRasterizer::numLayers;
+        auto& result = results[(size_t)n];
+
+        if (i == 0)
+            std::cout << "=== Preset: " << preset.name << " ===\n";
+
+        std::cout << "  Layer " << i << " (size=" << preset.sizes[i] << ", blur=" << GlowRasterizer::layerBlurRadii[i] << ")"
+                  << " rendered in " << juce::String(result.milliseconds, 1) << "ms, max error " << result.maxError << "\n";
+        maxError = juce::jmax(maxError, result.maxError);
+
+        if (i == GlowRasterizer::numLayers - 1)
+            std::cout << "\n";
     }
 
-    std::cout << "All presets generated successfully in: " << resourcesDir.getFullPathName() << "\n";
+    std::cout << "Largest channel difference from juce::ImageConvolutionKernel: " << maxError << "\n";
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    juce::initialiseJuce_GUI();
+
+    auto workingDirectory = juce::File::getCurrentWorkingDirectory();
+    int result = 0;
+
+    if (argc >= 3 && juce::String(argv[1]) == "--pack")
+    {
+        result = packGlowLayers(workingDirectory.getChildFile(argv[2]));
+    }
+    else if (argc >= 2 && juce::String(argv[1]) == "--check")
+    {
+        result = checkAgainstConvolutionKernel();
+    }
+    else
+    {
+        std::cerr << "Usage: GenerateAllPresetImages --pack <file> | --check\n";
+        result = 1;
+    }
 
     juce::shutdownJuce_GUI();
-    return 0;
+    return result;
 }
@@ -0,0 +1,465 @@
+#include <juce_gui_extra/juce_gui_extra.h>
+#include <juce_core/juce_core.h>
+#include "Source/XYControlComponent.h"
+#include "Source/ScriptedMouse.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <numeric>
+
+// Headless, deterministic frame-cost benchmark for XYControlComponent.
+//
+// Each scenario feeds the pad a scripted mouse trajectory, advances the
+// animation by exactly one 60 Hz frame per step and paints the whole pad into
+// an offscreen image, timing every frame. No window or display is needed.
+//
+//   RenderBenchmark [--frames N] [--warmup N] [--size WxH] [--scale S]
+//                   [--preset blue|red|black] [--backend juce|scalar|sse2|avx2|neon]
+//                   [--procedural] [--tiled] [--adaptive-quality] [--input-prediction]
+//                   [--scenario name] [--json file]
+//
+// The pad's adaptive quality governor is off unless --adaptive-quality is given,
+// so frames are always drawn the same way and runs can be compared.
+
+//==============================================================================
+// Counts heap allocations, so the report can show allocations per frame
+static std::atomic<juce::int64> allocationCount { 0 };
+
+void* operator new(std::size_t size)
+{
+    ++allocationCount;
+
+    if (auto* p = std::malloc(size == 0 ? 1 : size))
+        return p;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)                                { return operator new(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept  { ++allocationCount; return std::malloc(size == 0 ? 1 : size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { ++allocationCount; return std::malloc(size == 0 ? 1 : size); }
+void operator delete(void* p) noexcept                                { std::free(p); }
+void operator delete[](void* p) noexcept                              { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                   { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept                 { std::free(p); }
+
+//==============================================================================
+struct Settings
+{
+    int frames = 600;
+    int warmupFrames = 30;
+    int width = 316;
+    int height = 316;
+    float scale = 1.0f;
+    XYControlComponent::Preset preset = XYControlComponent::Preset::Blue;
+    GlowCompositor::Backend backend = GlowCompositor::Backend::Juce;
+    bool procedural = false;
+    bool tiled = false;
+    bool adaptiveQuality = false;
+    bool inputPrediction = false;
+    juce::String scenario;
+    juce::File jsonFile;
+};
+
+struct Scenario
+{
+    const char* name;
+    const char* description;
+    int idleFramesBefore;                                       // Advanced without painting
+    std::function<void(ScriptedMouse&, int frame)> script;      // Input for one frame
+};
+
+static const Scenario scenarios[] = {
+    { "drag", "Continuous drag along a Lissajous curve", 0,
+      [](ScriptedMouse& mouse, int frame)
+      {
+          auto t = (float)frame / 60.0f;
+          auto x = 0.5f + 0.35f * std::sin(juce::MathConstants<float>::twoPi * 0.7f * t);
+          auto y = 0.5f + 0.35f * std::sin(juce::MathConstants<float>::twoPi * 0.45f * t + 0.8f);
+
+          if (frame == 0)
+              mouse.down(x, y);
+          else
+              mouse.drag(x, y);
+      } },
+
+    { "fling", "Fast strokes across the pad, released mid-motion, every second", 0,
+      [](ScriptedMouse& mouse, int frame)
+      {
+          const int phase = frame % 60;
+          const bool leftToRight = (frame / 60) % 2 == 0;
+          auto xAt = [&](int step) { auto x = 0.15f + 0.7f * (float)step / 4.0f; return leftToRight ? x : 1.0f - x; };
+          const float y = 0.35f + 0.3f * (float)((frame / 60) % 3) / 2.0f;
+
+          if (phase == 0)
+              mouse.down(xAt(0), y);
+          else if (phase <= 4)
+              mouse.drag(xAt(phase), y);
+          else if (phase == 5)
+              mouse.up(xAt(4), y);
+      } },
+
+    { "disperse", "Double-click disperse every 45 frames", 0,
+      [](ScriptedMouse& mouse, int frame)
+      {
+          if (frame % 45 == 0)
+              mouse.doubleClick(0.5f, 0.5f);
+      } },
+
+    { "breathing", "Idle breathing after the springs have settled", 120,
+      [](ScriptedMouse&, int) {} },
+};
+
+//==============================================================================
+struct FrameSample
+{
+    double totalMs;
+    double glowMs;
+    std::array<double, 5> layerMs;
+    juce::int64 allocations;
+    int qualityLevel;
+};
+
+struct ScenarioResult
+{
+    juce::String name;
+    std::vector<FrameSample> samples;
+    QualityGovernor::Stats qualityStats;
+    XYControlComponent::InputLatencyStats inputLatency;
+};
+
+static double percentile(std::vector<double> values, double fraction)
+{
+    if (values.empty())
+        return 0.0;
+
+    std::sort(values.begin(), values.end());
+    auto index = (size_t)juce::jlimit(0.0, (double)(values.size() - 1), std::ceil(fraction * (double)values.size()) - 1.0);
+    return values[index];
+}
+
+template <typename Getter>
+static std::vector<double> collect(const std::vector<FrameSample>& samples, Getter&& getter)
+{
+    std::vector<double> values;
+    values.reserve(samples.size());
+
+    for (auto& sample : samples)
+        values.push_back((double)getter(sample));
+
+    return values;
+}
+
+static double mean(const std::vector<double>& values)
+{
+    return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / (double)values.size();
+}
+
+static ScenarioResult runScenario(const Scenario& scenario, const Settings& settings)
+{
+    XYControlComponent pad;
+    pad.setBounds(0, 0, settings.width, settings.height);
+    pad.setPreset(settings.preset);
+    pad.setRandomSeed(1);
+    pad.setCompositorBackend(settings.backend);
+    pad.setProceduralGlowEnabled(settings.procedural);
+    pad.setTiledRenderingEnabled(settings.tiled);
+    pad.setPaintTimingEnabled(true);
+    pad.setAdaptiveQualityEnabled(settings.adaptiveQuality);
+    pad.setInputPredictionEnabled(settings.inputPrediction);
+
+    juce::Image frame(juce::Image::ARGB,
+                      juce::roundToInt((float)settings.width * settings.scale),
+                      juce::roundToInt((float)settings.height * settings.scale),
+                      true, juce::SoftwareImageType());
+
+    ScriptedMouse mouse(pad);
+
+    auto renderFrame = [&]
+    {
+        juce::Graphics g(frame);
+        g.addTransform(juce::AffineTransform::scale(settings.scale));
+        pad.paintEntireComponent(g, true);
+    };
+
+    for (int i = 0; i < scenario.idleFramesBefore; ++i)
+        pad.advanceAnimation(1.0f);
+
+    // Warm-up frames load the glow resources and fill caches, and aren't reported
+    for (int i = 0; i < settings.warmupFrames; ++i)
+        renderFrame();
+
+    ScenarioResult result { scenario.name, {}, {}, {} };
+    result.samples.reserve((size_t)settings.frames);
+    pad.resetQualityStats();
+    pad.resetInputLatencyStats();
+
+    for (int i = 0; i < settings.frames; ++i)
+    {
+        scenario.script(mouse, i);
+        pad.advanceAnimation(1.0f);
+
+        auto allocationsBefore = allocationCount.load();
+        auto start = juce::Time::getHighResolutionTicks();
+
+        renderFrame();
+
+        auto elapsedMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) * 1000.0;
+        auto& timings = pad.getLastPaintTimings();
+        result.samples.push_back({ elapsedMs, timings.glowMs, timings.layerMs, allocationCount.load() - allocationsBefore,
+                                   (int)pad.getQualityStats().level });
+    }
+
+    result.qualityStats = pad.getQualityStats();
+    result.inputLatency = pad.getInputLatencyStats();
+    return result;
+}
+
+//==============================================================================
+static void printTable(const std::vector<ScenarioResult>& results, const Settings& settings)
+{
+    auto column = [](const juce::String& text, int width) { return text.paddedLeft(' ', width); };
+    auto ms = [&](double value) { return column(juce::String(value, 3), 9); };
+
+    std::cout << column("scenario", 10) << column("mean", 9) << column("p50", 9) << column("p90", 9)
+              << column("p99", 9) << column("max", 9) << column("glow", 9) << column("allocs", 8);
+
+    for (int i = 0; i < 5; ++i)
+        std::cout << column("layer" + juce::String(i), 9);
+
+    std::cout << "\n";
+
+    for (auto& result : results)
+    {
+        auto totals = collect(result.samples, [](auto& s) { return s.totalMs; });
+
+        std::cout << column(result.name, 10)
+                  << ms(mean(totals)) << ms(percentile(totals, 0.5)) << ms(percentile(totals, 0.9))
+                  << ms(percentile(totals, 0.99)) << ms(percentile(totals, 1.0))
+                  << ms(mean(collect(result.samples, [](auto& s) { return s.glowMs; })))
+                  << column(juce::String(mean(collect(result.samples, [](auto& s) { return s.allocations; })), 1), 8);
+
+        for (size_t layer = 0; layer < 5; ++layer)
+            std::cout << ms(mean(collect(result.samples, [layer](auto& s) { return s.layerMs[layer]; })));
+
+        std::cout << "\n";
+    }
+
+    std::cout << "\nTimes in ms (mean per frame for glow and layers). Per-layer times are only\n"
+                 "measured on the JUCE path; offscreen renderers report the glow total.\n";
+
+    // Offline there's no display, so this is the pad's own share (stepping and
+    // painting) plus a nominal 60 Hz refresh
+    std::cout << "\nInput to photon (estimated, ms):\n";
+
+    for (auto& result : results)
+        if (result.inputLatency.numSamples > 0)
+            std::cout << column(result.name, 10) << "  mean " << juce::String(result.inputLatency.meanMs, 3)
+                      << "  max " << juce::String(result.inputLatency.maxMs, 3)
+                      << "  (" << result.inputLatency.numSamples << " samples)\n";
+
+    if (!settings.adaptiveQuality)
+        return;
+
+    std::cout << "\nAdaptive quality (frames at each level):\n";
+
+    for (auto& result : results)
+    {
+        std::array<int, QualityGovernor::numLevels> framesAtLevel {};
+
+        for (auto& sample : result.samples)
+            ++framesAtLevel[(size_t)sample.qualityLevel];
+
+        std::cout << column(result.name, 10) << " ";
+
+        for (int level = 0; level < QualityGovernor::numLevels; ++level)
+            if (framesAtLevel[(size_t)level] > 0)
+                std::cout << " " << QualityGovernor::getLevelName((QualityGovernor::Level)level)
+                          << ": " << framesAtLevel[(size_t)level];
+
+        std::cout << " (" << result.qualityStats.numStepsDown << " down, " << result.qualityStats.numStepsUp << " up)\n";
+    }
+}
+
+static juce::var toJson(const std::vector<ScenarioResult>& results, const Settings& settings)
+{
+    auto root = std::make_unique<juce::DynamicObject>();
+
+    auto config = std::make_unique<juce::DynamicObject>();
+    config->setProperty("frames", settings.frames);
+    config->setProperty("warmupFrames", settings.warmupFrames);
+    config->setProperty("width", settings.width);
+    config->setProperty("height", settings.height);
+    config->setProperty("scale", settings.scale);
+    config->setProperty("preset", (int)settings.preset);
+    config->setProperty("backend", GlowCompositor::getBackendName(settings.backend));
+    config->setProperty("procedural", settings.procedural);
+    config->setProperty("tiled", settings.tiled);
+    config->setProperty("adaptiveQuality", settings.adaptiveQuality);
+    config->setProperty("inputPrediction", settings.inputPrediction);
+    root->setProperty("config", juce::var(config.release()));
+
+    juce::Array<juce::var> scenarioList;
+
+    for (auto& result : results)
+    {
+        auto totals = collect(result.samples, [](auto& s) { return s.totalMs; });
+        auto entry = std::make_unique<juce::DynamicObject>();
+
+        entry->setProperty("name", result.name);
+        entry->setProperty("meanMs", mean(totals));
+        entry->setProperty("p50Ms", percentile(totals, 0.5));
+        entry->setProperty("p90Ms", percentile(totals, 0.9));
+        entry->setProperty("p99Ms", percentile(totals, 0.99));
+        entry->setProperty("maxMs", percentile(totals, 1.0));
+        entry->setProperty("glowMeanMs", mean(collect(result.samples, [](auto& s) { return s.glowMs; })));
+        entry->setProperty("allocationsPerFrame", mean(collect(result.samples, [](auto& s) { return s.allocations; })));
+
+        juce::Array<juce::var> layers, frames, qualityLevels;
+
+        for (size_t layer = 0; layer < 5; ++layer)
+            layers.add(mean(collect(result.samples, [layer](auto& s) { return s.layerMs[layer]; })));
+
+        for (auto& sample : result.samples)
+        {
+            frames.add(sample.totalMs);
+            qualityLevels.add(sample.qualityLevel);
+        }
+
+        entry->setProperty("layerMeanMs", layers);
+        entry->setProperty("frameMs", frames);
+
+        if (result.inputLatency.numSamples > 0)
+        {
+            entry->setProperty("inputLatencyMeanMs", result.inputLatency.meanMs);
+            entry->setProperty("inputLatencyMaxMs", result.inputLatency.maxMs);
+        }
+
+        if (settings.adaptiveQuality)
+        {
+            entry->setProperty("qualityLevel", qualityLevels);
+            entry->setProperty("qualityStepsDown", result.qualityStats.numStepsDown);
+            entry->setProperty("qualityStepsUp", result.qualityStats.numStepsUp);
+        }
+
+        scenarioList.add(juce::var(entry.release()));
+    }
+
+    root->setProperty("scenarios", scenarioList);
+    return juce::var(root.release());
+}
+
+//==============================================================================
+static bool parseArguments(const juce::StringArray& args, Settings& settings)
+{
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto next = [&] { return i + 1 < args.size() ? args[++i] : juce::String(); };
+
+        if (arg == "--frames")              settings.frames = juce::jmax(1, next().getIntValue());
+        else if (arg == "--warmup")         settings.warmupFrames = juce::jmax(0, next().getIntValue());
+        else if (arg == "--scale")          settings.scale = juce::jlimit(0.25f, 8.0f, next().getFloatValue());
+        else if (arg == "--procedural")     settings.procedural = true;
+        else if (arg == "--tiled")          settings.tiled = true;
+        else if (arg == "--adaptive-quality") settings.adaptiveQuality = true;
+        else if (arg == "--input-prediction") settings.inputPrediction = true;
+        else if (arg == "--scenario")       settings.scenario = next();
+        else if (arg == "--json")           settings.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(next());
+        else if (arg == "--size")
+        {
+            auto size = next();
+            settings.width = juce::jmax(32, size.upToFirstOccurrenceOf("x", false, true).getIntValue());
+            settings.height = juce::jmax(32, size.fromFirstOccurrenceOf("x", false, true).getIntValue());
+        }
+        else if (arg == "--preset")
+        {
+            auto name = next().toLowerCase();
+            settings.preset = name == "red"   ? XYControlComponent::Preset::Red
+                            : name == "black" ? XYControlComponent::Preset::Black
+                                              : XYControlComponent::Preset::Blue;
+        }
+        else if (arg == "--backend")
+        {
+            auto name = next().toLowerCase();
+            bool found = false;
+
+            for (auto backend : { GlowCompositor::Backend::Juce, GlowCompositor::Backend::Scalar, GlowCompositor::Backend::SSE2,
+                                  GlowCompositor::Backend::AVX2, GlowCompositor::Backend::NEON })
+            {
+                if (GlowCompositor::getBackendName(backend).toLowerCase() == name)
+                {
+                    if (!GlowCompositor::isBackendAvailable(backend))
+                    {
+                        std::cerr << "Backend not available on this machine: " << name << "\n";
+                        return false;
+                    }
+
+                    settings.backend = backend;
+                    found = true;
+                }
+            }
+
+            if (!found)
+            {
+                std::cerr << "Unknown backend: " << name << "\n";
+                return false;
+            }
+        }
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    juce::initialiseJuce_GUI();
+
+    Settings settings;
+    juce::StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (!parseArguments(args, settings))
+    {
+        juce::shutdownJuce_GUI();
+        return 1;
+    }
+
+    std::cout << "XY pad render benchmark: " << settings.width << "x" << settings.height
+              << " @" << settings.scale << "x, " << GlowCompositor::getBackendName(settings.backend)
+              << (settings.procedural ? ", procedural" : "") << (settings.tiled ? ", tiled" : "")
+              << ", " << settings.frames << " frames per scenario\n\n";
+
+    std::vector<ScenarioResult> results;
+
+    for (auto& scenario : scenarios)
+        if (settings.scenario.isEmpty() || settings.scenario == scenario.name)
+            results.push_back(runScenario(scenario, settings));
+
+    if (results.empty())
+    {
+        std::cerr << "Unknown scenario: " << settings.scenario << "\n";
+        juce::shutdownJuce_GUI();
+        return 1;
+    }
+
+    printTable(results, settings);
+
+    if (settings.jsonFile != juce::File())
+    {
+        settings.jsonFile.replaceWithText(juce::JSON::toString(toJson(results, settings)));
+        std::cout << "\nWrote " << settings.jsonFile.getFullPathName() << "\n";
+    }
+
+    juce::shutdownJuce_GUI();
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include "EditorBackdrop.h"
+
+void EditorBackdrop::paint(juce::Graphics& g, juce::Rectangle<int> editorBounds)
+{
+    auto& theme = pad.getTheme();
+
+    Layout current;
+    current.editorBounds = editorBounds;
+    current.padBounds = pad.getBounds();
+    current.cornerRadius = pad.getCornerRadius();
+    current.background = theme.editorBackground;
+    current.shadow = theme.shadow;
+    current.scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (current != layout || !image.isValid())
+    {
+        layout = current;
+        render();
+        updatePadUnderlay();
+    }
+
+    // At the context's own scale, so this is a straight copy
+    g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+    g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / layout.scale)
+                                      .translated(layout.editorBounds.getPosition().toFloat()));
+}
+
+void EditorBackdrop::setPadUnderlayEnabled(bool shouldBeEnabled)
+{
+    if (padUnderlayEnabled == shouldBeEnabled)
+        return;
+
+    padUnderlayEnabled = shouldBeEnabled;
+    updatePadUnderlay();
+}
+
+void EditorBackdrop::render()
+{
+    auto pixelBounds = (layout.editorBounds.withZeroOrigin().toFloat() * layout.scale).getSmallestIntegerContainer();
+    image = juce::Image(juce::Image::ARGB, juce::jmax(1, pixelBounds.getWidth()), juce::jmax(1, pixelBounds.getHeight()),
+                        true, juce::SoftwareImageType());
+
+    juce::Graphics g(image);
+    g.addTransform(juce::AffineTransform::scale(layout.scale));
+
+    // Fill background with color matching the theme
+    g.fillAll(layout.background);
+
+    // Subtle drop shadow for depth (Apple-style)
+    auto controlBounds = layout.padBounds.toFloat() - layout.editorBounds.getPosition().toFloat();
+
+    juce::Path shadowPath;
+    shadowPath.addRoundedRectangle(controlBounds, layout.cornerRadius);
+
+    // All themes use dark shadows for uniformity
+    juce::DropShadow shadow(layout.shadow, 18, juce::Point<int>(0, 4));
+    shadow.drawForPath(g, shadowPath);
+}
+
+void EditorBackdrop::updatePadUnderlay()
+{
+    if (!padUnderlayEnabled || !image.isValid())
+    {
+        pad.setUnderlay({}, {});
+        return;
+    }
+
+    auto padOffset = layout.padBounds.getPosition() - layout.editorBounds.getPosition();
+    pad.setUnderlay(image, juce::AffineTransform::scale(1.0f / layout.scale).translated(-padOffset.toFloat()));
+}
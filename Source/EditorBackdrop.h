@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include "XYControlComponent.h"
+
+// The editor's static background: the theme's fill and the pad's drop shadow.
+// The shadow is a blur, far too slow to redo for every frame the pad animates,
+// so both are rendered into an image only when the layout, theme or display
+// scale changes. The pad gets the same image as its underlay, which makes it
+// opaque: its repaints then no longer repaint the editor behind it.
+//
+// Shared by the standalone MainComponent and the plugin editor.
+class EditorBackdrop
+{
+public:
+    explicit EditorBackdrop(XYControlComponent& padToServe) : pad(padToServe) {}
+
+    // Call from the editor's paint(), before anything drawn on top
+    void paint(juce::Graphics& g, juce::Rectangle<int> editorBounds);
+
+    // Anything the editor draws across the pad's edge (the hold ring) would be
+    // hidden by an opaque pad, so turn the underlay off while it shows
+    void setPadUnderlayEnabled(bool shouldBeEnabled);
+
+private:
+    struct Layout
+    {
+        juce::Rectangle<int> editorBounds, padBounds;
+        float cornerRadius = 0.0f;
+        juce::Colour background, shadow;
+        float scale = 0.0f;
+
+        bool operator==(const Layout& other) const
+        {
+            return editorBounds == other.editorBounds && padBounds == other.padBounds
+                && cornerRadius == other.cornerRadius && background == other.background
+                && shadow == other.shadow && scale == other.scale;
+        }
+
+        bool operator!=(const Layout& other) const { return !operator==(other); }
+    };
+
+    void render();
+    void updatePadUnderlay();
+
+    XYControlComponent& pad;
+    Layout layout;
+    juce::Image image;      // Editor-sized, at layout.scale physical pixels per logical pixel
+    bool padUnderlayEnabled = true;
+};
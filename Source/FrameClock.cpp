@@ -0,0 +1,156 @@
+#include "FrameClock.h"
+
+FrameClock::FrameClock(juce::Component& componentToSyncWith)
+    : component(componentToSyncWith)
+{
+}
+
+FrameClock::~FrameClock()
+{
+    cancelPendingUpdate();
+    stopTimer();
+}
+
+void FrameClock::start(int maxFramesPerSecond)
+{
+    minFrameIntervalMs = maxFramesPerSecond > 0 ? 1000.0 / maxFramesPerSecond : 0.0;
+
+    if (running)
+        return;
+
+    running = true;
+    resetTime();
+
+    if (vblankAttachment == nullptr)
+        vblankAttachment = std::make_unique<juce::VBlankAttachment>(&component, [this] { vblankCallback(); });
+
+    // While vblanks are arriving the timer is only a watchdog for them stopping;
+    // until the first one does, it keeps the frames coming
+    if (getTimeMs() - lastVBlankMs < vblankTimeoutMs)
+        startTimer((int)vblankTimeoutMs);
+    else
+        startTimerHz(fallbackRate);
+}
+
+void FrameClock::stop()
+{
+    if (!running)
+        return;
+
+    running = false;
+    stopTimer();
+    stats.isDisplaySynced = false;
+
+    // The attachment can't be deleted from inside its own callback
+    if (isInsideVBlankCallback)
+        triggerAsyncUpdate();
+    else
+        vblankAttachment.reset();
+}
+
+void FrameClock::handleAsyncUpdate()
+{
+    if (!running)
+        vblankAttachment.reset();
+}
+
+void FrameClock::resetTime()
+{
+    lastFrameMs = getTimeMs();
+}
+
+void FrameClock::resetStats()
+{
+    auto periodMs = stats.vblankPeriodMs;
+    auto isDisplaySynced = stats.isDisplaySynced;
+
+    stats = {};
+    stats.vblankPeriodMs = periodMs;
+    stats.isDisplaySynced = isDisplaySynced;
+    frameMsSumSquares = 0.0;
+}
+
+void FrameClock::timerCallback()
+{
+    auto nowMs = getTimeMs();
+
+    // Vblanks are arriving, so they're in charge and the timer just watches for them stopping
+    if (nowMs - lastVBlankMs < vblankTimeoutMs)
+    {
+        if (getTimerInterval() != (int)vblankTimeoutMs)
+            startTimer((int)vblankTimeoutMs);
+
+        return;
+    }
+
+    // No vblanks for a while, so keep the frames coming at the fallback rate
+    stats.isDisplaySynced = false;
+
+    if (getTimerInterval() != 1000 / fallbackRate)
+        startTimerHz(fallbackRate);
+
+    if (nowMs - lastFrameMs >= minFrameIntervalMs - 1.0)
+        deliverFrame(nowMs);
+}
+
+void FrameClock::vblankCallback()
+{
+    if (!running)
+        return;
+
+    auto nowMs = getTimeMs();
+
+    if (stats.isDisplaySynced)
+        recordVBlankInterval(nowMs - lastVBlankMs);
+
+    lastVBlankMs = nowMs;
+    stats.isDisplaySynced = true;
+
+    // When capped, take the vblank closest to the wanted interval
+    auto halfPeriodMs = stats.vblankPeriodMs * 0.5;
+
+    if (nowMs - lastFrameMs >= minFrameIntervalMs - halfPeriodMs)
+    {
+        const juce::ScopedValueSetter<bool> inCallback(isInsideVBlankCallback, true);
+        deliverFrame(nowMs);
+    }
+}
+
+void FrameClock::recordVBlankInterval(double intervalMs)
+{
+    auto& periodMs = stats.vblankPeriodMs;
+
+    if (periodMs <= 0.0 || intervalMs < periodMs * 0.75)
+    {
+        // First measurement, or a faster display than we thought (e.g. moved to another monitor)
+        periodMs = intervalMs;
+        return;
+    }
+
+    if (intervalMs < periodMs * 1.5)
+    {
+        // Smooth out scheduling noise in the period estimate
+        periodMs += (intervalMs - periodMs) * 0.05;
+        return;
+    }
+
+    // The message thread was busy for more than one refresh
+    stats.missedVBlanks += juce::jmax(1, juce::roundToInt(intervalMs / periodMs) - 1);
+}
+
+void FrameClock::deliverFrame(double nowMs)
+{
+    auto elapsedMs = nowMs - lastFrameMs;
+    lastFrameMs = nowMs;
+
+    // Welford's online mean and variance
+    ++stats.numFrames;
+    auto delta = elapsedMs - stats.meanFrameMs;
+    stats.meanFrameMs += delta / stats.numFrames;
+    frameMsSumSquares += delta * (elapsedMs - stats.meanFrameMs);
+    stats.frameMsVariance = stats.numFrames > 1 ? frameMsSumSquares / (stats.numFrames - 1) : 0.0;
+    stats.maxFrameMs = juce::jmax(stats.maxFrameMs, elapsedMs);
+
+    if (onFrame != nullptr)
+        onFrame(elapsedMs);
+}
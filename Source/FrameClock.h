@@ -0,0 +1,75 @@
+#pragma once
+
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <functional>
+#include <memory>
+
+// Drives an animation from the display's vertical blank rather than from a
+// free-running message-thread timer, so frames land once per refresh at
+// whatever rate the monitor runs (60, 120, 144 Hz...) and the time between
+// them is measured with a high-resolution monotonic clock.
+//
+// Vblank callbacks only arrive while the component is on screen. Whenever
+// none have come for a while (offscreen, minimised, headless), a fallback
+// timer keeps the animation going at 60 Hz. While vblanks do arrive, that
+// timer only wakes once per timeout to see whether they've stopped.
+class FrameClock : private juce::Timer,
+                   private juce::AsyncUpdater
+{
+public:
+    explicit FrameClock(juce::Component& componentToSyncWith);
+    ~FrameClock() override;
+
+    // Called once per frame with the time since the previous one, in ms
+    std::function<void(double elapsedMs)> onFrame;
+
+    // Runs at the display rate, or with maxFramesPerSecond > 0 skips vblanks so
+    // frames come no faster than that (evenly spaced whole numbers of vblanks)
+    void start(int maxFramesPerSecond = 0);
+    void stop();
+    bool isRunning() const { return running; }
+
+    // Makes the next frame's elapsed time start from now, e.g. after a pause
+    void resetTime();
+
+    // Milliseconds on a monotonic high-resolution clock
+    static double getTimeMs() { return juce::Time::getMillisecondCounterHiRes(); }
+
+    struct Stats
+    {
+        int numFrames = 0;
+        double meanFrameMs = 0.0;
+        double frameMsVariance = 0.0;   // Jitter of the time between delivered frames, in ms^2
+        double maxFrameMs = 0.0;
+        double vblankPeriodMs = 0.0;    // Estimated display refresh period (0 until known)
+        int missedVBlanks = 0;          // Refreshes that came and went without a callback
+        bool isDisplaySynced = false;   // Currently driven by vblanks rather than the fallback timer
+    };
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+
+private:
+    void timerCallback() override;
+    void handleAsyncUpdate() override;
+    void vblankCallback();
+    void deliverFrame(double nowMs);
+    void recordVBlankInterval(double intervalMs);
+
+    static constexpr int fallbackRate = 60;
+    static constexpr double vblankTimeoutMs = 100.0;
+
+    juce::Component& component;
+    std::unique_ptr<juce::VBlankAttachment> vblankAttachment;
+
+    bool running = false;
+    bool isInsideVBlankCallback = false;
+    double minFrameIntervalMs = 0.0;
+    double lastFrameMs = 0.0;
+    double lastVBlankMs = 0.0;
+
+    Stats stats;
+    double frameMsSumSquares = 0.0;     // Welford's running sum of squared deviations
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameClock)
+};
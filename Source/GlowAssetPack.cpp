@@ -0,0 +1,230 @@
+#include "GlowAssetPack.h"
+
+namespace
+{
+    constexpr char packMagic[4] = { 'X', 'Y', 'G', 'L' };
+    constexpr size_t headerSize = 16;
+    constexpr size_t entrySize = 32;
+    constexpr uint32_t maxEntries = 1024;
+
+    int getPixelStride(GlowAssetPack::Format format)
+    {
+        return format == GlowAssetPack::Format::alphaMask ? 1 : 4;
+    }
+
+    juce::Image::PixelFormat getImageFormat(GlowAssetPack::Format format)
+    {
+        return format == GlowAssetPack::Format::alphaMask ? juce::Image::SingleChannel : juce::Image::ARGB;
+    }
+
+    // Image pixels that live in someone else's read-only memory. Reading them
+    // costs nothing; the first write (which the glow code never does) takes a
+    // private copy first, so the shared bytes are never touched.
+    class BorrowedPixelData : public juce::ImagePixelData
+    {
+    public:
+        BorrowedPixelData(juce::Image::PixelFormat format, int w, int h, const uint8_t* data, int stride)
+            : juce::ImagePixelData(format, w, h),
+              pixels(data),
+              lineStride(stride),
+              pixelStride(format == juce::Image::SingleChannel ? 1 : 4)
+        {
+        }
+
+        std::unique_ptr<juce::LowLevelGraphicsContext> createLowLevelContext() override
+        {
+            makeWritable();
+            sendDataChangeMessage();
+            return std::make_unique<juce::LowLevelGraphicsSoftwareRenderer>(juce::Image(this));
+        }
+
+        void initialiseBitmapData(juce::Image::BitmapData& bitmap, int x, int y,
+                                  juce::Image::BitmapData::ReadWriteMode mode) override
+        {
+            if (mode != juce::Image::BitmapData::readOnly)
+                makeWritable();
+
+            auto offset = (size_t)x * (size_t)pixelStride + (size_t)y * (size_t)lineStride;
+            bitmap.data = const_cast<uint8_t*>(pixels) + offset;
+            bitmap.size = (size_t)height * (size_t)lineStride - offset;
+            bitmap.pixelFormat = pixelFormat;
+            bitmap.lineStride = lineStride;
+            bitmap.pixelStride = pixelStride;
+
+            if (mode != juce::Image::BitmapData::readOnly)
+                sendDataChangeMessage();
+        }
+
+        juce::ImagePixelData::Ptr clone() override
+        {
+            return new BorrowedPixelData(*this);
+        }
+
+        std::unique_ptr<juce::ImageType> createType() const override
+        {
+            // Pixels in main memory, just like a software image
+            return std::make_unique<juce::SoftwareImageType>();
+        }
+
+    private:
+        BorrowedPixelData(const BorrowedPixelData& other)
+            : juce::ImagePixelData(other.pixelFormat, other.width, other.height),
+              pixels(other.pixels),
+              lineStride(other.lineStride),
+              pixelStride(other.pixelStride)
+        {
+            // Clones are made to be written to, so don't bother sharing
+            makeWritable();
+        }
+
+        void makeWritable()
+        {
+            if (ownCopy != nullptr)
+                return;
+
+            auto numBytes = (size_t)height * (size_t)lineStride;
+            ownCopy.malloc(numBytes);
+            std::memcpy(ownCopy.get(), pixels, numBytes);
+            pixels = ownCopy.get();
+        }
+
+        const uint8_t* pixels;
+        juce::HeapBlock<uint8_t> ownCopy;
+        const int lineStride, pixelStride;
+    };
+}
+
+GlowAssetPack::GlowAssetPack(const void* data, size_t size)
+{
+    auto* bytes = static_cast<const uint8_t*>(data);
+
+    if (bytes == nullptr || size < headerSize || std::memcmp(bytes, packMagic, sizeof(packMagic)) != 0)
+        return;
+
+    auto readField = [bytes](size_t offset) { return juce::ByteOrder::littleEndianInt(bytes + offset); };
+
+    if (readField(4) != currentVersion)
+        return;
+
+    auto numEntries = readField(8);
+
+    if (numEntries > maxEntries || headerSize + numEntries * entrySize > size)
+        return;
+
+    std::vector<Entry> parsed;
+
+    for (uint32_t i = 0; i < numEntries; ++i)
+    {
+        auto base = headerSize + i * entrySize;
+
+        Entry entry;
+        entry.layer = readField(base);
+        entry.glowSize = readField(base + 4);
+        entry.format = static_cast<Format>(readField(base + 8));
+        entry.width = readField(base + 12);
+        entry.height = readField(base + 16);
+        entry.lineStride = readField(base + 20);
+        auto offset = (uint64_t)readField(base + 24);
+        auto dataSize = (uint64_t)readField(base + 28);
+
+        // A pack that doesn't add up is ignored as a whole
+        if (entry.format != Format::premultipliedARGB && entry.format != Format::alphaMask)
+            return;
+
+        if (entry.width == 0 || entry.height == 0 || entry.width > 16384 || entry.height > 16384
+            || entry.lineStride < entry.width * (uint32_t)getPixelStride(entry.format)
+            || entry.lineStride % (uint32_t)getPixelStride(entry.format) != 0
+            || dataSize < (uint64_t)entry.lineStride * entry.height
+            || offset + dataSize > size)
+            return;
+
+        entry.pixels = bytes + offset;
+        parsed.push_back(entry);
+    }
+
+    entries = std::move(parsed);
+}
+
+juce::Image GlowAssetPack::getImage(int layer, int glowSize) const
+{
+    for (auto& entry : entries)
+    {
+        if (entry.layer != (uint32_t)layer || entry.glowSize != (uint32_t)glowSize)
+            continue;
+
+        auto format = getImageFormat(entry.format);
+        auto* pixelData = new BorrowedPixelData(format, (int)entry.width, (int)entry.height,
+                                                entry.pixels, (int)entry.lineStride);
+        juce::Image image(pixelData);
+
+        // The packer aligns every layer, but the embedded array itself may not be:
+        // ARGB pixels are read as whole 32-bit words, so take an aligned copy
+        auto misaligned = reinterpret_cast<uintptr_t>(entry.pixels) % alignof(uint32_t) != 0;
+
+        if (entry.format == Format::premultipliedARGB && misaligned)
+            return image.createCopy();
+
+        return image;
+    }
+
+    return {};
+}
+
+int GlowAssetPack::findNearestGlowSize(int layer, int glowSize) const
+{
+    int nearest = 0;
+
+    for (auto& entry : entries)
+        if (entry.layer == (uint32_t)layer
+            && (nearest == 0 || std::abs((int)entry.glowSize - glowSize) < std::abs(nearest - glowSize)))
+            nearest = (int)entry.glowSize;
+
+    return nearest;
+}
+
+bool GlowAssetPack::write(const std::vector<SourceImage>& images, juce::OutputStream& output)
+{
+    auto alignUp = [](size_t n) { return (n + dataAlignment - 1) / dataAlignment * dataAlignment; };
+
+    bool ok = output.write(packMagic, sizeof(packMagic))
+           && output.writeInt((int)currentVersion)
+           && output.writeInt((int)images.size())
+           && output.writeInt(0);
+
+    // Entries first, so the offsets are known before any pixels are written
+    auto offset = alignUp(headerSize + images.size() * entrySize);
+    std::vector<size_t> offsets;
+
+    for (auto& source : images)
+    {
+        auto lineStride = (size_t)source.image.getWidth() * (size_t)getPixelStride(source.format);
+        auto dataSize = lineStride * (size_t)source.image.getHeight();
+
+        ok = ok && output.writeInt(source.layer)
+                && output.writeInt(source.glowSize)
+                && output.writeInt((int)source.format)
+                && output.writeInt(source.image.getWidth())
+                && output.writeInt(source.image.getHeight())
+                && output.writeInt((int)lineStride)
+                && output.writeInt((int)offset)
+                && output.writeInt((int)dataSize);
+
+        offsets.push_back(offset);
+        offset = alignUp(offset + dataSize);
+    }
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        auto& source = images[i];
+        ok = ok && output.writeRepeatedByte(0, offsets[i] - (size_t)output.getPosition());
+
+        auto image = juce::SoftwareImageType().convert(source.image.convertedToFormat(getImageFormat(source.format)));
+        const juce::Image::BitmapData data(image, juce::Image::BitmapData::readOnly);
+
+        for (int y = 0; y < data.height; ++y)
+            ok = ok && output.write(data.getLinePointer(y), (size_t)data.width * (size_t)data.pixelStride);
+    }
+
+    output.flush();
+    return ok;
+}
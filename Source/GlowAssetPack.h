@@ -0,0 +1,72 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <cstdint>
+#include <vector>
+
+// The glow layers as raw pixels, in the layout JUCE keeps them in memory.
+// GenerateAllPresetImages renders and packs them at build time and the pack is embedded as
+// BinaryData::glow_layers_bin, so loading a layer is just wrapping an image
+// around the embedded bytes: no decode, no copy.
+//
+// Layers are stored as alpha masks, tinted with the theme's colours when they
+// are composited, so there is one mask per layer and glow size rather than
+// one image per preset.
+//
+// Layout (header fields little-endian):
+//
+//   Header  magic "XYGL", version, number of entries, reserved
+//   Entry   layer, glow size, format, width, height, lineStride, offset, size
+//           (one per mask, offsets from the start of the pack)
+//   Pixels  each mask's rows, starting on a dataAlignment boundary
+class GlowAssetPack
+{
+public:
+    enum class Format : uint32_t
+    {
+        premultipliedARGB = 0,  // PixelARGB, as juce::Image::ARGB, drawn as it is
+        alphaMask = 1           // One byte per pixel, as juce::Image::SingleChannel, drawn tinted
+    };
+
+    static constexpr uint32_t currentVersion = 2;
+    static constexpr size_t dataAlignment = 64;
+
+    // Parses a pack held in memory; the data must outlive the pack and every
+    // image taken from it (embedded binary data always does)
+    GlowAssetPack(const void* data, size_t size);
+
+    bool isValid() const { return !entries.empty(); }
+    int getNumEntries() const { return (int)entries.size(); }
+
+    // Returns the stored image for a layer baked at the given glow size, or an
+    // invalid image if the pack doesn't have it. The image reads the pack's bytes
+    // in place, unless they aren't aligned for their pixel format, in which case
+    // it gets a copy.
+    juce::Image getImage(int layer, int glowSize) const;
+
+    // The glow size closest to the wanted one that the pack has for a layer
+    // (0 if it has none), to be scaled to the wanted size when drawn
+    int findNearestGlowSize(int layer, int glowSize) const;
+
+    // Generator side: writes a pack holding the given layer images
+    struct SourceImage
+    {
+        int layer;
+        int glowSize;           // Diameter of the glow before blurring
+        juce::Image image;      // Converted to the format's pixels (alpha only, for a mask)
+        Format format;
+    };
+
+    static bool write(const std::vector<SourceImage>& images, juce::OutputStream& output);
+
+private:
+    struct Entry
+    {
+        uint32_t layer, glowSize;
+        Format format;
+        uint32_t width, height, lineStride;
+        const uint8_t* pixels;
+    };
+
+    std::vector<Entry> entries;
+};
@@ -0,0 +1,251 @@
+#include "GlowCompositor.h"
+#include "GlowCompositorKernel.h"
+#include <algorithm>
+
+void GlowCompositorDetail::fillArea(const Destination& destination, std::uint32_t pixel)
+{
+    for (int y = destination.top; y < destination.bottom; ++y)
+    {
+        auto* line = reinterpret_cast<std::uint32_t*>(destination.data + y * destination.lineStride);
+        std::fill(line + destination.left, line + destination.right, pixel);
+    }
+}
+
+namespace
+{
+    bool isAVX2Available()
+    {
+       #if XYCONTROL_COMPOSITOR_SSE2
+        // Compositing an empty area tells us whether the AVX2 kernel was compiled in
+        static const bool available = juce::SystemStats::hasAVX2()
+                                   && GlowCompositorDetail::compositeAVX2({ nullptr, 0, 0, 0, 0, 0 }, nullptr, 0);
+        return available;
+       #else
+        return false;
+       #endif
+    }
+
+    void compositeWithJuce(juce::Image& destination, juce::Rectangle<int> area,
+                           const GlowCompositor::Layer* layers, int numLayers)
+    {
+        juce::Graphics g(destination);
+        g.reduceClipRegion(area);
+        g.setImageResamplingQuality(juce::Graphics::mediumResamplingQuality);
+
+        for (int i = 0; i < numLayers; ++i)
+        {
+            // An alpha mask is filled with its tint; an ARGB image is drawn as it is
+            bool isMask = layers[i].image.getFormat() == juce::Image::SingleChannel;
+            g.setColour(layers[i].colour.withAlpha(1.0f));
+            g.setOpacity(layers[i].opacity);
+            g.drawImageTransformed(layers[i].image, layers[i].transform, isMask);
+        }
+    }
+}
+
+bool GlowCompositor::isBackendAvailable(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::Juce:
+        case Backend::Scalar:   return true;
+        case Backend::SSE2:     return XYCONTROL_COMPOSITOR_SSE2 != 0;
+        case Backend::AVX2:     return isAVX2Available();
+        case Backend::NEON:     return XYCONTROL_COMPOSITOR_NEON != 0;
+    }
+
+    return false;
+}
+
+GlowCompositor::Backend GlowCompositor::getBestAvailableBackend()
+{
+    for (auto backend : { Backend::AVX2, Backend::SSE2, Backend::NEON })
+        if (isBackendAvailable(backend))
+            return backend;
+
+    return Backend::Scalar;
+}
+
+juce::String GlowCompositor::getBackendName(Backend backend)
+{
+    switch (backend)
+    {
+        case Backend::Juce:     return "JUCE";
+        case Backend::Scalar:   return "Scalar";
+        case Backend::SSE2:     return "SSE2";
+        case Backend::AVX2:     return "AVX2";
+        case Backend::NEON:     return "NEON";
+    }
+
+    return {};
+}
+
+void GlowCompositor::composite(Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+                               const Layer* layers, int numLayers)
+{
+    Pass pass(backend, destination, area, layers, numLayers);
+    pass.render(pass.getArea());
+}
+
+//==============================================================================
+GlowCompositor::Pass::Pass(Backend backendToUse, juce::Image& destinationImage, juce::Rectangle<int> areaToRender,
+                           const Layer* layersToBlend, int numLayersToBlend, std::optional<juce::Colour> backgroundColour)
+    : backend(backendToUse),
+      destination(destinationImage),
+      area(areaToRender.getIntersection(destinationImage.getBounds())),
+      layers(layersToBlend),
+      numLayers(numLayersToBlend),
+      background(backgroundColour)
+{
+    jassert(destination.getFormat() == juce::Image::ARGB);
+    jassert(numLayers <= maxLayers);
+
+    if (!isBackendAvailable(backend) || numLayers > maxLayers)
+        backend = Backend::Juce;
+
+    if (area.isEmpty() || backend == Backend::Juce)
+        return;
+
+    for (int i = 0; i < numLayers; ++i)
+    {
+        auto& layer = layers[i];
+
+        if (!layer.image.isValid() || layer.opacity <= 0.0f || layer.transform.isSingularity())
+            continue;
+
+        jassert(layer.image.getFormat() == juce::Image::ARGB || layer.image.getFormat() == juce::Image::SingleChannel);
+
+        auto bounds = layer.image.getBounds().toFloat().transformedBy(layer.transform)
+                          .getSmallestIntegerContainer().expanded(1).getIntersection(area);
+
+        if (bounds.isEmpty())
+            continue;
+
+        auto& data = sourceData[(size_t)i].emplace(layer.image, juce::Image::BitmapData::readOnly);
+        auto inverse = layer.transform.inverted();
+
+        // Maps a destination pixel centre to texel coordinates (texel centres sit at +0.5)
+        auto& setup = setups[(size_t)numSetups++];
+        bool isMask = layer.image.getFormat() == juce::Image::SingleChannel;
+        setup.pixels = isMask ? nullptr : reinterpret_cast<const std::uint32_t*>(data.data);
+        setup.alpha = isMask ? data.data : nullptr;
+        setup.tint[0] = layer.colour.getFloatBlue();
+        setup.tint[1] = layer.colour.getFloatGreen();
+        setup.tint[2] = layer.colour.getFloatRed();
+        setup.lineStride = data.lineStride / data.pixelStride;
+        setup.maxX = (float)(data.width - 1);
+        setup.maxY = (float)(data.height - 1);
+        setup.ux = inverse.mat00;
+        setup.uy = inverse.mat01;
+        setup.u0 = inverse.mat02 - 0.5f;
+        setup.vx = inverse.mat10;
+        setup.vy = inverse.mat11;
+        setup.v0 = inverse.mat12 - 0.5f;
+        setup.opacity = juce::jmin(1.0f, layer.opacity);
+        setup.left = bounds.getX();
+        setup.top = bounds.getY();
+        setup.right = bounds.getRight();
+        setup.bottom = bounds.getBottom();
+    }
+
+    // Mapped once here: creating BitmapData isn't safe to do from several threads
+    destinationData.emplace(destination, juce::Image::BitmapData::readWrite);
+    jassert(destinationData->pixelStride == 4);
+}
+
+void GlowCompositor::Pass::render(juce::Rectangle<int> tile) const
+{
+    tile = tile.getIntersection(area);
+
+    if (tile.isEmpty())
+        return;
+
+    if (backend == Backend::Juce)
+    {
+        if (background.has_value())
+            destination.clear(tile, *background);
+
+        compositeWithJuce(destination, tile, layers, numLayers);
+        return;
+    }
+
+    GlowCompositorDetail::Destination target { destinationData->data, destinationData->lineStride,
+                                               tile.getX(), tile.getY(), tile.getRight(), tile.getBottom() };
+
+    if (background.has_value())
+        GlowCompositorDetail::fillArea(target, background->getPixelARGB().getNativeARGB());
+
+    switch (backend)
+    {
+        case Backend::AVX2:
+            GlowCompositorDetail::compositeAVX2(target, setups.data(), numSetups);
+            break;
+
+       #if XYCONTROL_COMPOSITOR_SSE2
+        case Backend::SSE2:
+            compositeArea<SSE2Ops>(target, setups.data(), numSetups);
+            break;
+       #endif
+
+       #if XYCONTROL_COMPOSITOR_NEON
+        case Backend::NEON:
+            compositeArea<NEONOps>(target, setups.data(), numSetups);
+            break;
+       #endif
+
+        default:
+            compositeArea<ScalarOps>(target, setups.data(), numSetups);
+            break;
+    }
+}
+
+//==============================================================================
+double GlowCompositor::compareWithJuce(Backend backend, juce::Rectangle<int> area, juce::Colour background,
+                                       const Layer* layers, int numLayers)
+{
+    auto render = [&](Backend backendToUse)
+    {
+        juce::Image image(juce::Image::ARGB, area.getRight(), area.getBottom(), true, juce::SoftwareImageType());
+
+        {
+            juce::Graphics g(image);
+            g.setColour(background);
+            g.fillRect(area);
+        }
+
+        composite(backendToUse, image, area, layers, numLayers);
+        return image.getClippedImage(area);
+    };
+
+    return computePSNR(render(backend), render(Backend::Juce));
+}
+
+double GlowCompositor::computePSNR(const juce::Image& a, const juce::Image& b)
+{
+    jassert(a.getBounds() == b.getBounds());
+    jassert(a.getFormat() == juce::Image::ARGB && b.getFormat() == juce::Image::ARGB);
+
+    juce::Image::BitmapData dataA(a, juce::Image::BitmapData::readOnly);
+    juce::Image::BitmapData dataB(b, juce::Image::BitmapData::readOnly);
+
+    double sumSquaredError = 0.0;
+    const int bytesPerLine = a.getWidth() * dataA.pixelStride;
+
+    for (int y = 0; y < a.getHeight(); ++y)
+    {
+        auto* lineA = dataA.getLinePointer(y);
+        auto* lineB = dataB.getLinePointer(y);
+
+        for (int i = 0; i < bytesPerLine; ++i)
+        {
+            auto difference = (double)lineA[i] - (double)lineB[i];
+            sumSquaredError += difference * difference;
+        }
+    }
+
+    if (sumSquaredError == 0.0)
+        return std::numeric_limits<double>::infinity();
+
+    auto meanSquaredError = sumSquaredError / ((double)bytesPerLine * a.getHeight());
+    return 10.0 * std::log10(255.0 * 255.0 / meanSquaredError);
+}
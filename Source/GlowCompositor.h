@@ -0,0 +1,87 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <array>
+#include <optional>
+#include "GlowCompositorDetail.h"
+
+// Software compositor for the XY pad's glow layers. Instead of handing each
+// layer to the generic renderer, the SIMD backends make a single pass over the
+// destination and, for every pixel, sample and blend all the layers at once.
+// The Juce backend draws through juce::Graphics and is the reference path the
+// others are checked against.
+class GlowCompositor
+{
+public:
+    enum class Backend
+    {
+        Juce = 0,
+        Scalar,
+        SSE2,
+        AVX2,
+        NEON
+    };
+
+    struct Layer
+    {
+        juce::Image image;                  // Premultiplied ARGB, or a SingleChannel alpha mask;
+                                            // ideally a SoftwareImageType image so reading its
+                                            // pixels is free
+        juce::AffineTransform transform;    // Image space to destination space
+        float opacity = 1.0f;
+        juce::Colour colour;                // Tint of an alpha mask (alpha is ignored)
+    };
+
+    static constexpr int maxLayers = 16;
+
+    static bool isBackendAvailable(Backend backend);
+    static Backend getBestAvailableBackend();
+    static juce::String getBackendName(Backend backend);
+
+    // Blends the layers, back to front, over the existing contents of an ARGB
+    // destination image, touching only the pixels inside area
+    static void composite(Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+                          const Layer* layers, int numLayers);
+
+    // One composite, prepared once (layer setup and pixel access) so that its
+    // area can then be rendered in pieces. With a SIMD backend, disjoint tiles
+    // may be rendered concurrently from different threads; the Juce backend
+    // draws through a Graphics context and must stay on one thread.
+    class Pass
+    {
+    public:
+        // The layers must outlive the pass. If background is given, each tile is
+        // filled with it before the layers are blended.
+        Pass(Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+             const Layer* layers, int numLayers, std::optional<juce::Colour> background = {});
+
+        juce::Rectangle<int> getArea() const { return area; }
+
+        void render(juce::Rectangle<int> tile) const;
+
+    private:
+        Backend backend;
+        juce::Image& destination;
+        juce::Rectangle<int> area;
+        const Layer* layers;
+        int numLayers;
+        std::optional<juce::Colour> background;
+
+        // Source bitmaps stay mapped while the kernel reads them
+        std::array<std::optional<juce::Image::BitmapData>, maxLayers> sourceData;
+        std::array<GlowCompositorDetail::LayerSetup, maxLayers> setups;
+        int numSetups = 0;
+        std::optional<juce::Image::BitmapData> destinationData;
+
+        JUCE_DECLARE_NON_COPYABLE(Pass)
+    };
+
+    // Renders the same layers with a backend and with the Juce path over the
+    // given background, and returns the PSNR between the two in dB
+    static double compareWithJuce(Backend backend, juce::Rectangle<int> area, juce::Colour background,
+                                  const Layer* layers, int numLayers);
+
+    // Peak signal-to-noise ratio in dB between two equally sized images
+    // (infinity when they are identical)
+    static double computePSNR(const juce::Image& a, const juce::Image& b);
+};
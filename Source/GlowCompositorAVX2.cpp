@@ -0,0 +1,107 @@
+// Built with AVX2 code generation enabled (see CMakeLists.txt) and only ever
+// called after a runtime check that the CPU supports it.
+
+#include "GlowCompositorKernel.h"
+
+#if XYCONTROL_COMPOSITOR_SSE2 && defined(__AVX2__)
+ #include <immintrin.h>
+
+namespace
+{
+    struct AVX2Ops
+    {
+        static constexpr int width = 8;
+        using Float = __m256;
+        using Int = __m256i;
+
+        static Float set1(float v)                   { return _mm256_set1_ps(v); }
+        static Float ramp(float start)
+        {
+            return _mm256_add_ps(_mm256_set1_ps(start), _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f));
+        }
+        static Float add(Float a, Float b)           { return _mm256_add_ps(a, b); }
+        static Float sub(Float a, Float b)           { return _mm256_sub_ps(a, b); }
+        static Float mul(Float a, Float b)           { return _mm256_mul_ps(a, b); }
+        static Float min(Float a, Float b)           { return _mm256_min_ps(a, b); }
+        static Float max(Float a, Float b)           { return _mm256_max_ps(a, b); }
+
+        static Float floorFromMinusOne(Float v)      { return _mm256_floor_ps(v); }
+
+        static Float inRange(Float v, float limit)
+        {
+            auto mask = _mm256_and_ps(_mm256_cmp_ps(v, _mm256_setzero_ps(), _CMP_GE_OQ),
+                                      _mm256_cmp_ps(v, _mm256_set1_ps(limit), _CMP_LE_OQ));
+            return _mm256_and_ps(mask, _mm256_set1_ps(1.0f));
+        }
+
+        static Int toIndex(Float v)                  { return _mm256_cvttps_epi32(v); }
+        static Float sqrt(Float v)                   { return _mm256_sqrt_ps(v); }
+
+        static Int gather(const std::uint32_t* base, Int index)
+        {
+            return _mm256_i32gather_epi32((const int*)base, index, 4);
+        }
+
+        static Float gather(const float* base, Int index)
+        {
+            return _mm256_i32gather_ps(base, index, 4);
+        }
+
+        // No byte gather, and a 32-bit one could read past the end of the mask
+        static Float gather(const std::uint8_t* base, Int index)
+        {
+            alignas(32) std::int32_t i[8];
+            _mm256_store_si256((__m256i*)i, index);
+            return _mm256_setr_ps((float)base[i[0]], (float)base[i[1]], (float)base[i[2]], (float)base[i[3]],
+                                  (float)base[i[4]], (float)base[i[5]], (float)base[i[6]], (float)base[i[7]]);
+        }
+
+        template <int shift>
+        static Float channel(Int pixels)
+        {
+            return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, shift), _mm256_set1_epi32(0xff)));
+        }
+
+        static Int load(const std::uint32_t* p)       { return _mm256_loadu_si256((const __m256i*)p); }
+        static void store(std::uint32_t* p, Int v)    { _mm256_storeu_si256((__m256i*)p, v); }
+
+        static Int pack(Float b, Float g, Float r, Float a)
+        {
+            auto toByte = [](Float c)
+            {
+                c = _mm256_min_ps(_mm256_max_ps(c, _mm256_setzero_ps()), _mm256_set1_ps(255.0f));
+                return _mm256_cvttps_epi32(_mm256_add_ps(c, _mm256_set1_ps(0.5f)));
+            };
+
+            return _mm256_or_si256(_mm256_or_si256(toByte(b), _mm256_slli_epi32(toByte(g), 8)),
+                                   _mm256_or_si256(_mm256_slli_epi32(toByte(r), 16), _mm256_slli_epi32(toByte(a), 24)));
+        }
+    };
+}
+
+bool GlowCompositorDetail::compositeAVX2(const Destination& destination, const LayerSetup* layers, int numLayers)
+{
+    compositeArea<AVX2Ops>(destination, layers, numLayers);
+    return true;
+}
+
+bool GlowCompositorDetail::renderProceduralAVX2(const Destination& destination,
+                                                const ProceduralLayerSetup* layers, int numLayers)
+{
+    renderProceduralArea<AVX2Ops>(destination, layers, numLayers);
+    return true;
+}
+
+#else
+
+bool GlowCompositorDetail::compositeAVX2(const Destination&, const LayerSetup*, int)
+{
+    return false;
+}
+
+bool GlowCompositorDetail::renderProceduralAVX2(const Destination&, const ProceduralLayerSetup*, int)
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+
+// Plain data shared between GlowCompositor, ProceduralGlow and their SIMD
+// kernels. Like GlowCompositorKernel.h this is also compiled with AVX2 enabled,
+// so it holds declarations only and includes no JUCE headers.
+
+#include <cstdint>
+
+namespace GlowCompositorDetail
+{
+    // One glow layer, prepared for sampling: the inverse transform maps a
+    // destination pixel centre straight to source texel coordinates
+    struct LayerSetup
+    {
+        const std::uint32_t* pixels;    // Premultiplied ARGB, or null for an alpha mask
+        const std::uint8_t* alpha;      // Alpha mask, tinted with tint, or null
+        float tint[3];                  // b, g, r (0..1)
+        int lineStride;                 // In pixels
+        float maxX, maxY;           // Last valid texel
+        float ux, uy, u0;           // u = ux * x + uy * y + u0
+        float vx, vy, v0;           // v = vx * x + vy * y + v0
+        float opacity;
+        int left, top, right, bottom;   // Destination pixels the layer can touch
+    };
+
+    // A block of destination pixels: premultiplied ARGB, one uint32 per pixel
+    struct Destination
+    {
+        std::uint8_t* data;
+        int lineStride;                 // In bytes
+        int left, top, right, bottom;   // Area to composite
+    };
+
+    // A procedural glow layer: alpha comes from a falloff table indexed by the
+    // distance from the glow centre instead of from an image
+    struct ProceduralLayerSetup
+    {
+        const float* profile;           // profileSize entries plus a trailing zero
+        float profileScale;             // Table entries per unit of distance
+        float maxIndex;                 // profileSize - 1
+        float ux, uy, u0;               // Destination pixel centre to glow space
+        float vx, vy, v0;
+        float colour[4];                // b, g, r, a (0..255), scaled by the layer opacity
+        int left, top, right, bottom;
+    };
+
+    // Sets every pixel of the destination area to one premultiplied ARGB value
+    void fillArea(const Destination& destination, std::uint32_t pixel);
+
+    // Defined in GlowCompositorAVX2.cpp; these return false if that file was built without AVX2
+    bool compositeAVX2(const Destination& destination, const LayerSetup* layers, int numLayers);
+    bool renderProceduralAVX2(const Destination& destination, const ProceduralLayerSetup* layers, int numLayers);
+}
@@ -0,0 +1,425 @@
+#pragma once
+
+// Internal to GlowCompositor. The kernel is written once against a small set of
+// vector operations and instantiated per instruction set.
+//
+// This header is also compiled into a translation unit built with AVX2 enabled,
+// so it deliberately includes no JUCE headers and keeps all its code in an
+// anonymous namespace: an AVX2 copy of a shared inline function must never be
+// picked by the linker for use elsewhere.
+
+#include "GlowCompositorDetail.h"
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #include <emmintrin.h>
+ #define XYCONTROL_COMPOSITOR_SSE2 1
+#else
+ #define XYCONTROL_COMPOSITOR_SSE2 0
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+ #include <arm_neon.h>
+ #define XYCONTROL_COMPOSITOR_NEON 1
+#else
+ #define XYCONTROL_COMPOSITOR_NEON 0
+#endif
+
+namespace
+{
+    using GlowCompositorDetail::LayerSetup;
+    using GlowCompositorDetail::Destination;
+    using GlowCompositorDetail::ProceduralLayerSetup;
+
+    //==============================================================================
+    struct ScalarOps
+    {
+        static constexpr int width = 1;
+        using Float = float;
+        using Int = std::uint32_t;
+
+        static Float set1(float v)                   { return v; }
+        static Float ramp(float start)               { return start; }
+        static Float add(Float a, Float b)           { return a + b; }
+        static Float sub(Float a, Float b)           { return a - b; }
+        static Float mul(Float a, Float b)           { return a * b; }
+        static Float min(Float a, Float b)           { return a < b ? a : b; }
+        static Float max(Float a, Float b)           { return a > b ? a : b; }
+
+        // Valid for v >= -1, which the kernel guarantees by clamping first
+        static Float floorFromMinusOne(Float v)      { return (float)(int)(v + 1.0f) - 1.0f; }
+        static Float inRange(Float v, float limit)   { return (v >= 0.0f && v <= limit) ? 1.0f : 0.0f; }
+        static Int toIndex(Float v)                  { return (Int)(int)v; }
+
+        static Float sqrt(Float v)
+        {
+           #if XYCONTROL_COMPOSITOR_SSE2
+            return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(v)));
+           #else
+            return std::sqrt(v);
+           #endif
+        }
+
+        static Int gather(const std::uint32_t* base, Int index) { return base[index]; }
+        static Float gather(const float* base, Int index)       { return base[index]; }
+        static Float gather(const std::uint8_t* base, Int index) { return (float)base[index]; }
+
+        template <int shift>
+        static Float channel(Int pixels)             { return (float)((pixels >> shift) & 0xff); }
+
+        static Int load(const std::uint32_t* p)       { return *p; }
+        static void store(std::uint32_t* p, Int v)    { *p = v; }
+
+        static Int pack(Float b, Float g, Float r, Float a)
+        {
+            auto toByte = [](float c) { return (std::uint32_t)(int)(min(max(c, 0.0f), 255.0f) + 0.5f); };
+            return toByte(b) | (toByte(g) << 8) | (toByte(r) << 16) | (toByte(a) << 24);
+        }
+    };
+
+    //==============================================================================
+   #if XYCONTROL_COMPOSITOR_SSE2
+    struct SSE2Ops
+    {
+        static constexpr int width = 4;
+        using Float = __m128;
+        using Int = __m128i;
+
+        static Float set1(float v)                   { return _mm_set1_ps(v); }
+        static Float ramp(float start)               { return _mm_setr_ps(start, start + 1.0f, start + 2.0f, start + 3.0f); }
+        static Float add(Float a, Float b)           { return _mm_add_ps(a, b); }
+        static Float sub(Float a, Float b)           { return _mm_sub_ps(a, b); }
+        static Float mul(Float a, Float b)           { return _mm_mul_ps(a, b); }
+        static Float min(Float a, Float b)           { return _mm_min_ps(a, b); }
+        static Float max(Float a, Float b)           { return _mm_max_ps(a, b); }
+
+        static Float floorFromMinusOne(Float v)
+        {
+            auto one = _mm_set1_ps(1.0f);
+            return _mm_sub_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(v, one))), one);
+        }
+
+        static Float inRange(Float v, float limit)
+        {
+            auto mask = _mm_and_ps(_mm_cmpge_ps(v, _mm_setzero_ps()), _mm_cmple_ps(v, _mm_set1_ps(limit)));
+            return _mm_and_ps(mask, _mm_set1_ps(1.0f));
+        }
+
+        static Int toIndex(Float v)                  { return _mm_cvttps_epi32(v); }
+        static Float sqrt(Float v)                   { return _mm_sqrt_ps(v); }
+
+        static Int gather(const std::uint32_t* base, Int index)
+        {
+            alignas(16) std::int32_t i[4];
+            _mm_store_si128((__m128i*)i, index);
+            return _mm_setr_epi32((int)base[i[0]], (int)base[i[1]], (int)base[i[2]], (int)base[i[3]]);
+        }
+
+        static Float gather(const float* base, Int index)
+        {
+            alignas(16) std::int32_t i[4];
+            _mm_store_si128((__m128i*)i, index);
+            return _mm_setr_ps(base[i[0]], base[i[1]], base[i[2]], base[i[3]]);
+        }
+
+        static Float gather(const std::uint8_t* base, Int index)
+        {
+            alignas(16) std::int32_t i[4];
+            _mm_store_si128((__m128i*)i, index);
+            return _mm_setr_ps((float)base[i[0]], (float)base[i[1]], (float)base[i[2]], (float)base[i[3]]);
+        }
+
+        template <int shift>
+        static Float channel(Int pixels)
+        {
+            return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, shift), _mm_set1_epi32(0xff)));
+        }
+
+        static Int load(const std::uint32_t* p)       { return _mm_loadu_si128((const __m128i*)p); }
+        static void store(std::uint32_t* p, Int v)    { _mm_storeu_si128((__m128i*)p, v); }
+
+        static Int pack(Float b, Float g, Float r, Float a)
+        {
+            auto toByte = [](Float c)
+            {
+                c = _mm_min_ps(_mm_max_ps(c, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+                return _mm_cvttps_epi32(_mm_add_ps(c, _mm_set1_ps(0.5f)));
+            };
+
+            return _mm_or_si128(_mm_or_si128(toByte(b), _mm_slli_epi32(toByte(g), 8)),
+                                _mm_or_si128(_mm_slli_epi32(toByte(r), 16), _mm_slli_epi32(toByte(a), 24)));
+        }
+    };
+   #endif
+
+    //==============================================================================
+   #if XYCONTROL_COMPOSITOR_NEON
+    struct NEONOps
+    {
+        static constexpr int width = 4;
+        using Float = float32x4_t;
+        using Int = uint32x4_t;
+
+        static Float set1(float v)                   { return vdupq_n_f32(v); }
+        static Float ramp(float start)
+        {
+            const float values[4] = { start, start + 1.0f, start + 2.0f, start + 3.0f };
+            return vld1q_f32(values);
+        }
+        static Float add(Float a, Float b)           { return vaddq_f32(a, b); }
+        static Float sub(Float a, Float b)           { return vsubq_f32(a, b); }
+        static Float mul(Float a, Float b)           { return vmulq_f32(a, b); }
+        static Float min(Float a, Float b)           { return vminq_f32(a, b); }
+        static Float max(Float a, Float b)           { return vmaxq_f32(a, b); }
+
+        static Float floorFromMinusOne(Float v)
+        {
+            auto one = vdupq_n_f32(1.0f);
+            return vsubq_f32(vcvtq_f32_s32(vcvtq_s32_f32(vaddq_f32(v, one))), one);
+        }
+
+        static Float inRange(Float v, float limit)
+        {
+            auto mask = vandq_u32(vcgeq_f32(v, vdupq_n_f32(0.0f)), vcleq_f32(v, vdupq_n_f32(limit)));
+            return vreinterpretq_f32_u32(vandq_u32(mask, vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+        }
+
+        static Int toIndex(Float v)                  { return vcvtq_u32_f32(v); }
+        static Float sqrt(Float v)                   { return vsqrtq_f32(v); }
+
+        static Int gather(const std::uint32_t* base, Int index)
+        {
+            std::uint32_t i[4];
+            vst1q_u32(i, index);
+            const std::uint32_t values[4] = { base[i[0]], base[i[1]], base[i[2]], base[i[3]] };
+            return vld1q_u32(values);
+        }
+
+        static Float gather(const float* base, Int index)
+        {
+            std::uint32_t i[4];
+            vst1q_u32(i, index);
+            const float values[4] = { base[i[0]], base[i[1]], base[i[2]], base[i[3]] };
+            return vld1q_f32(values);
+        }
+
+        static Float gather(const std::uint8_t* base, Int index)
+        {
+            std::uint32_t i[4];
+            vst1q_u32(i, index);
+            const float values[4] = { (float)base[i[0]], (float)base[i[1]], (float)base[i[2]], (float)base[i[3]] };
+            return vld1q_f32(values);
+        }
+
+        template <int shift>
+        static Float channel(Int pixels)
+        {
+            return vcvtq_f32_u32(vandq_u32(vshrq_n_u32(pixels, shift), vdupq_n_u32(0xff)));
+        }
+
+        static Int load(const std::uint32_t* p)       { return vld1q_u32(p); }
+        static void store(std::uint32_t* p, Int v)    { vst1q_u32(p, v); }
+
+        static Int pack(Float b, Float g, Float r, Float a)
+        {
+            auto toByte = [](Float c)
+            {
+                c = vminq_f32(vmaxq_f32(c, vdupq_n_f32(0.0f)), vdupq_n_f32(255.0f));
+                return vcvtq_u32_f32(vaddq_f32(c, vdupq_n_f32(0.5f)));
+            };
+
+            return vorrq_u32(vorrq_u32(toByte(b), vshlq_n_u32(toByte(g), 8)),
+                             vorrq_u32(vshlq_n_u32(toByte(r), 16), vshlq_n_u32(toByte(a), 24)));
+        }
+    };
+   #endif
+
+    //==============================================================================
+    // Composites Ops::width destination pixels starting at (x, y), reading every
+    // layer for each of them and blending back to front with premultiplied src-over
+    template <typename Ops>
+    inline void compositePixels(std::uint32_t* destination, int x, int y,
+                                const LayerSetup* layers, int numLayers)
+    {
+        using Float = typename Ops::Float;
+        using Int = typename Ops::Int;
+
+        const Float px = Ops::ramp((float)x + 0.5f);
+        const Float py = Ops::set1((float)y + 0.5f);
+        const Float one = Ops::set1(1.0f);
+
+        Int dst = Ops::load(destination);
+        Float b = Ops::template channel<0>(dst);
+        Float g = Ops::template channel<8>(dst);
+        Float r = Ops::template channel<16>(dst);
+        Float a = Ops::template channel<24>(dst);
+
+        for (int i = 0; i < numLayers; ++i)
+        {
+            auto& layer = layers[i];
+
+            if (y < layer.top || y >= layer.bottom || x + Ops::width <= layer.left || x >= layer.right)
+                continue;
+
+            // Texel coordinates, clamped just outside the image so the index maths stays in range
+            Float u = Ops::add(Ops::add(Ops::mul(Ops::set1(layer.ux), px), Ops::mul(Ops::set1(layer.uy), py)), Ops::set1(layer.u0));
+            Float v = Ops::add(Ops::add(Ops::mul(Ops::set1(layer.vx), px), Ops::mul(Ops::set1(layer.vy), py)), Ops::set1(layer.v0));
+            u = Ops::min(Ops::max(u, Ops::set1(-1.0f)), Ops::set1(layer.maxX + 1.0f));
+            v = Ops::min(Ops::max(v, Ops::set1(-1.0f)), Ops::set1(layer.maxY + 1.0f));
+
+            Float x0 = Ops::floorFromMinusOne(u);
+            Float y0 = Ops::floorFromMinusOne(v);
+            Float x1 = Ops::add(x0, one);
+            Float y1 = Ops::add(y0, one);
+            Float fx = Ops::sub(u, x0);
+            Float fy = Ops::sub(v, y0);
+
+            // Bilinear weights, with texels outside the image contributing nothing
+            Float wx0 = Ops::mul(Ops::sub(one, fx), Ops::inRange(x0, layer.maxX));
+            Float wx1 = Ops::mul(fx, Ops::inRange(x1, layer.maxX));
+            Float wy0 = Ops::mul(Ops::mul(Ops::sub(one, fy), Ops::inRange(y0, layer.maxY)), Ops::set1(layer.opacity));
+            Float wy1 = Ops::mul(Ops::mul(fy, Ops::inRange(y1, layer.maxY)), Ops::set1(layer.opacity));
+
+            auto clampX = [&](Float c) { return Ops::min(Ops::max(c, Ops::set1(0.0f)), Ops::set1(layer.maxX)); };
+            auto clampY = [&](Float c) { return Ops::mul(Ops::min(Ops::max(c, Ops::set1(0.0f)), Ops::set1(layer.maxY)),
+                                                         Ops::set1((float)layer.lineStride)); };
+
+            Float row0 = clampY(y0), row1 = clampY(y1);
+            Float col0 = clampX(x0), col1 = clampX(x1);
+
+            const Int i00 = Ops::toIndex(Ops::add(row0, col0));
+            const Int i10 = Ops::toIndex(Ops::add(row0, col1));
+            const Int i01 = Ops::toIndex(Ops::add(row1, col0));
+            const Int i11 = Ops::toIndex(Ops::add(row1, col1));
+
+            const Float w00 = Ops::mul(wx0, wy0), w10 = Ops::mul(wx1, wy0);
+            const Float w01 = Ops::mul(wx0, wy1), w11 = Ops::mul(wx1, wy1);
+
+            Float sb, sg, sr, sa;
+
+            if (layer.alpha != nullptr)
+            {
+                // Alpha mask: one coverage sample, coloured by the tint
+                sa = Ops::add(Ops::add(Ops::mul(Ops::gather(layer.alpha, i00), w00), Ops::mul(Ops::gather(layer.alpha, i10), w10)),
+                              Ops::add(Ops::mul(Ops::gather(layer.alpha, i01), w01), Ops::mul(Ops::gather(layer.alpha, i11), w11)));
+                sb = Ops::mul(sa, Ops::set1(layer.tint[0]));
+                sg = Ops::mul(sa, Ops::set1(layer.tint[1]));
+                sr = Ops::mul(sa, Ops::set1(layer.tint[2]));
+            }
+            else
+            {
+                const Int p00 = Ops::gather(layer.pixels, i00);
+                const Int p10 = Ops::gather(layer.pixels, i10);
+                const Int p01 = Ops::gather(layer.pixels, i01);
+                const Int p11 = Ops::gather(layer.pixels, i11);
+
+                auto sample = [&](auto channelOf)
+                {
+                    return Ops::add(Ops::add(Ops::mul(channelOf(p00), w00), Ops::mul(channelOf(p10), w10)),
+                                    Ops::add(Ops::mul(channelOf(p01), w01), Ops::mul(channelOf(p11), w11)));
+                };
+
+                sb = sample([](Int p) { return Ops::template channel<0>(p); });
+                sg = sample([](Int p) { return Ops::template channel<8>(p); });
+                sr = sample([](Int p) { return Ops::template channel<16>(p); });
+                sa = sample([](Int p) { return Ops::template channel<24>(p); });
+            }
+
+            // Premultiplied src-over
+            Float inverseAlpha = Ops::sub(one, Ops::mul(sa, Ops::set1(1.0f / 255.0f)));
+            b = Ops::add(sb, Ops::mul(b, inverseAlpha));
+            g = Ops::add(sg, Ops::mul(g, inverseAlpha));
+            r = Ops::add(sr, Ops::mul(r, inverseAlpha));
+            a = Ops::add(sa, Ops::mul(a, inverseAlpha));
+        }
+
+        Ops::store(destination, Ops::pack(b, g, r, a));
+    }
+
+    template <typename Ops>
+    void compositeArea(const Destination& destination, const LayerSetup* layers, int numLayers)
+    {
+        for (int y = destination.top; y < destination.bottom; ++y)
+        {
+            auto* line = reinterpret_cast<std::uint32_t*>(destination.data + y * destination.lineStride);
+            int x = destination.left;
+
+            for (; x + Ops::width <= destination.right; x += Ops::width)
+                compositePixels<Ops>(line + x, x, y, layers, numLayers);
+
+            for (; x < destination.right; ++x)
+                compositePixels<ScalarOps>(line + x, x, y, layers, numLayers);
+        }
+    }
+
+    //==============================================================================
+    // Procedural counterpart of compositePixels: evaluates each layer's falloff
+    // from its distance table rather than sampling an image
+    template <typename Ops>
+    inline void renderProceduralPixels(std::uint32_t* destination, int x, int y,
+                                       const ProceduralLayerSetup* layers, int numLayers)
+    {
+        using Float = typename Ops::Float;
+        using Int = typename Ops::Int;
+
+        const Float px = Ops::ramp((float)x + 0.5f);
+        const Float py = Ops::set1((float)y + 0.5f);
+        const Float one = Ops::set1(1.0f);
+
+        Int dst = Ops::load(destination);
+        Float b = Ops::template channel<0>(dst);
+        Float g = Ops::template channel<8>(dst);
+        Float r = Ops::template channel<16>(dst);
+        Float a = Ops::template channel<24>(dst);
+
+        for (int i = 0; i < numLayers; ++i)
+        {
+            auto& layer = layers[i];
+
+            if (y < layer.top || y >= layer.bottom || x + Ops::width <= layer.left || x >= layer.right)
+                continue;
+
+            Float u = Ops::add(Ops::add(Ops::mul(Ops::set1(layer.ux), px), Ops::mul(Ops::set1(layer.uy), py)), Ops::set1(layer.u0));
+            Float v = Ops::add(Ops::add(Ops::mul(Ops::set1(layer.vx), px), Ops::mul(Ops::set1(layer.vy), py)), Ops::set1(layer.v0));
+
+            // Position in the falloff table, linearly interpolated
+            Float position = Ops::mul(Ops::sqrt(Ops::add(Ops::mul(u, u), Ops::mul(v, v))), Ops::set1(layer.profileScale));
+            position = Ops::min(position, Ops::set1(layer.maxIndex));
+
+            Float index = Ops::floorFromMinusOne(position);
+            Float fraction = Ops::sub(position, index);
+            Int i0 = Ops::toIndex(index);
+            Int i1 = Ops::toIndex(Ops::add(index, one));
+
+            Float a0 = Ops::gather(layer.profile, i0);
+            Float a1 = Ops::gather(layer.profile, i1);
+            Float alpha = Ops::add(a0, Ops::mul(Ops::sub(a1, a0), fraction));
+
+            // Premultiplied src-over
+            Float sa = Ops::mul(alpha, Ops::set1(layer.colour[3]));
+            Float inverseAlpha = Ops::sub(one, Ops::mul(sa, Ops::set1(1.0f / 255.0f)));
+            b = Ops::add(Ops::mul(alpha, Ops::set1(layer.colour[0])), Ops::mul(b, inverseAlpha));
+            g = Ops::add(Ops::mul(alpha, Ops::set1(layer.colour[1])), Ops::mul(g, inverseAlpha));
+            r = Ops::add(Ops::mul(alpha, Ops::set1(layer.colour[2])), Ops::mul(r, inverseAlpha));
+            a = Ops::add(sa, Ops::mul(a, inverseAlpha));
+        }
+
+        Ops::store(destination, Ops::pack(b, g, r, a));
+    }
+
+    template <typename Ops>
+    void renderProceduralArea(const Destination& destination, const ProceduralLayerSetup* layers, int numLayers)
+    {
+        for (int y = destination.top; y < destination.bottom; ++y)
+        {
+            auto* line = reinterpret_cast<std::uint32_t*>(destination.data + y * destination.lineStride);
+            int x = destination.left;
+
+            for (; x + Ops::width <= destination.right; x += Ops::width)
+                renderProceduralPixels<Ops>(line + x, x, y, layers, numLayers);
+
+            for (; x < destination.right; ++x)
+                renderProceduralPixels<ScalarOps>(line + x, x, y, layers, numLayers);
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#include "GlowImageCache.h"
+
+GlowImageCache::SpritesPtr GlowImageCache::getSprites(const Key& key, const std::function<juce::Image()>& createImage)
+{
+    if (auto existing = findSprites(key))
+        return existing;
+
+    // Decode without holding the lock, so other keys aren't held up
+    auto image = createImage();
+
+    // Packed layers come in as software images wrapping the embedded pixels, so
+    // the software compositor uses them as they are; the platform renderer wants
+    // its own image type, which costs one copy
+    if (key.softwareImages)
+        image = juce::SoftwareImageType().convert(image);
+    else
+        image = juce::NativeImageType().convert(image);
+
+    auto created = std::make_shared<const GlowSpriteCache>(image);
+
+    const juce::ScopedLock sl(lock);
+    auto& entry = entries[key];
+
+    // Another thread may have got there first; everyone shares the same copy
+    if (auto existing = entry.lock())
+        return existing;
+
+    entry = created;
+
+    // Forget entries that nobody holds any more
+    for (auto it = entries.begin(); it != entries.end();)
+        it = it->second.expired() ? entries.erase(it) : std::next(it);
+
+    return created;
+}
+
+GlowImageCache::SpritesPtr GlowImageCache::findSprites(const Key& key) const
+{
+    const juce::ScopedLock sl(lock);
+    auto it = entries.find(key);
+    return it != entries.end() ? it->second.lock() : nullptr;
+}
+
+int GlowImageCache::getNumLiveEntries() const
+{
+    const juce::ScopedLock sl(lock);
+    int numLive = 0;
+
+    for (auto& [key, entry] : entries)
+        if (!entry.expired())
+            ++numLive;
+
+    return numLive;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <functional>
+#include <map>
+#include <memory>
+#include <tuple>
+#include "GlowSpriteCache.h"
+
+// Loaded glow masks (with their pre-filtered sprites), shared by every pad in
+// the process whatever its theme, so opening another editor costs no extra
+// image memory. Hold it through juce::SharedResourcePointer<GlowImageCache>.
+//
+// Entries are immutable once created and reference counted: the cache only
+// keeps weak references, so an entry is freed as soon as no pad uses it.
+// Safe to use from any thread.
+class GlowImageCache
+{
+public:
+    struct Key
+    {
+        int layer;
+        int glowSize;           // Diameter of the glow in design pixels
+        float scale;            // Pixels per design pixel the mask was drawn at (1 for the baked masks)
+        bool softwareImages;    // Pixels in main memory, for the software compositor
+
+        bool operator<(const Key& other) const
+        {
+            return std::tie(layer, glowSize, scale, softwareImages)
+                 < std::tie(other.layer, other.glowSize, other.scale, other.softwareImages);
+        }
+    };
+
+    using SpritesPtr = std::shared_ptr<const GlowSpriteCache>;
+
+    // Returns the shared sprites for key, calling createImage to make the source
+    // image (outside the cache's lock) only if no pad currently holds them
+    SpritesPtr getSprites(const Key& key, const std::function<juce::Image()>& createImage);
+
+    // Returns the shared sprites if some pad already holds them, without creating any
+    SpritesPtr findSprites(const Key& key) const;
+
+    int getNumLiveEntries() const;
+
+private:
+    std::map<Key, std::weak_ptr<const GlowSpriteCache>> entries;
+    juce::CriticalSection lock;
+};
+
+// One low-priority background thread, shared process-wide, for decoding glow
+// images ahead of time. Also held through juce::SharedResourcePointer; jobs
+// still running when the last holder goes away are waited for.
+struct GlowImageLoader
+{
+    juce::ThreadPool pool { juce::ThreadPoolOptions{}.withThreadName("Glow image loader")
+                                                     .withNumberOfThreads(1)
+                                                     .withDesiredThreadPriority(juce::Thread::Priority::low) };
+};
@@ -0,0 +1,141 @@
+#include "GlowRasterizer.h"
+#include <iterator>
+
+const float GlowRasterizer::layerOpacities[numLayers] = { 0.95f, 0.75f, 0.60f, 0.45f, 0.35f };
+const int GlowRasterizer::layerBlurRadii[numLayers] = { 15, 20, 30, 40, 50 };
+
+juce::Image GlowRasterizer::renderGradient(int glowSize, juce::Colour colour, int blurRadius)
+{
+    int imageSize = glowSize + blurRadius * 2;
+    juce::Image image(juce::Image::ARGB, imageSize, imageSize, true, juce::SoftwareImageType());
+
+    juce::Graphics g(image);
+
+    float centre = imageSize / 2.0f;
+    float radius = glowSize / 2.0f;
+
+    juce::ColourGradient gradient(colour, centre, centre, colour.withAlpha(0.0f), centre + radius, centre, true);
+
+    for (size_t i = 1; i + 1 < std::size(gradientStops); ++i)
+        gradient.addColour(gradientStops[i][0], colour.withMultipliedAlpha(gradientStops[i][1]));
+
+    g.setGradientFill(gradient);
+    g.fillEllipse(centre - radius, centre - radius, radius * 2, radius * 2);
+
+    return image;
+}
+
+juce::Image GlowRasterizer::renderGlow(int glowSize, juce::Colour colour, int blurRadius)
+{
+    auto image = renderGradient(glowSize, colour, blurRadius);
+    applyGaussianBlur(image, blurRadius);
+    return image;
+}
+
+juce::Image GlowRasterizer::renderGlowMask(int glowSize, float opacity, int blurRadius)
+{
+    // Channels blur independently, so dropping the colour first changes nothing
+    auto image = renderGradient(glowSize, juce::Colours::white.withAlpha(opacity), blurRadius)
+                     .convertedToFormat(juce::Image::SingleChannel);
+    applyGaussianBlur(image, blurRadius);
+    return image;
+}
+
+std::vector<float> GlowRasterizer::createGaussianKernel(int blurRadius)
+{
+    // Same taps as juce::ImageConvolutionKernel(blurRadius).createGaussianBlur(blurRadius * 0.4f)
+    const int taps = juce::jmax(1, blurRadius);
+    const int centre = taps / 2;
+    const double sigma = juce::jmax(0.001, blurRadius * 0.4);
+
+    std::vector<float> kernel((size_t)taps);
+    double sum = 0.0;
+
+    for (int i = 0; i < taps; ++i)
+    {
+        kernel[(size_t)i] = (float)std::exp(-(double)((i - centre) * (i - centre)) / (2.0 * sigma * sigma));
+        sum += kernel[(size_t)i];
+    }
+
+    for (auto& weight : kernel)
+        weight = (float)(weight / sum);
+
+    return kernel;
+}
+
+void GlowRasterizer::applyGaussianBlur(juce::Image& image, int blurRadius)
+{
+    if (blurRadius <= 0 || !image.isValid())
+        return;
+
+    const auto kernel = createGaussianKernel(blurRadius);
+    const int taps = (int)kernel.size();
+    const int centre = taps / 2;
+
+    const juce::Image::BitmapData data(image, juce::Image::BitmapData::readWrite);
+    const int width = data.width;
+    const int height = data.height;
+    const auto planeSize = (size_t)width * (size_t)height;
+
+    // One channel at a time, as a plane of floats, so each tap is a single
+    // multiply-add along a whole row
+    juce::HeapBlock<float> plane(planeSize), rows(planeSize);
+
+    for (int channel = 0; channel < data.pixelStride; ++channel)
+    {
+        for (int y = 0; y < height; ++y)
+        {
+            auto* line = data.getLinePointer(y) + channel;
+            auto* out = plane + (size_t)y * (size_t)width;
+
+            for (int x = 0; x < width; ++x)
+                out[x] = (float)line[x * data.pixelStride];
+        }
+
+        // Rows: each output pixel gathers from x - centre .. x - centre + taps - 1
+        rows.clear(planeSize);
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* in = plane + (size_t)y * (size_t)width;
+            auto* out = rows + (size_t)y * (size_t)width;
+
+            for (int k = 0; k < taps; ++k)
+            {
+                int offset = k - centre;
+                int start = juce::jmax(0, -offset);
+                int end = juce::jmin(width, width - offset);
+
+                if (end > start)
+                    juce::FloatVectorOperations::addWithMultiply(out + start, in + start + offset,
+                                                                 kernel[(size_t)k], end - start);
+            }
+        }
+
+        // Columns, back into the plane: whole source rows at a time
+        plane.clear(planeSize);
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* out = plane + (size_t)y * (size_t)width;
+
+            for (int k = 0; k < taps; ++k)
+            {
+                int sourceY = y + k - centre;
+
+                if (sourceY >= 0 && sourceY < height)
+                    juce::FloatVectorOperations::addWithMultiply(out, rows + (size_t)sourceY * (size_t)width,
+                                                                 kernel[(size_t)k], width);
+            }
+        }
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* line = data.getLinePointer(y) + channel;
+            auto* in = plane + (size_t)y * (size_t)width;
+
+            for (int x = 0; x < width; ++x)
+                line[x * data.pixelStride] = (juce::uint8)juce::jmin(0xff, juce::roundToInt(in[x]));
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <vector>
+
+// Draws the glow layers: a radial gradient disc, blurred with a Gaussian.
+// GenerateAllPresetImages uses it to bake the layers, and the pad uses it for
+// glow sizes that weren't baked.
+//
+// The blur is the one juce::ImageConvolutionKernel gives for
+// createGaussianBlur(blurRadius * 0.4f) on a blurRadius-tap kernel. That kernel
+// is separable, so it runs as a row pass and a column pass of vectorised
+// multiply-adds: 2 * blurRadius taps per pixel instead of blurRadius².
+class GlowRasterizer
+{
+public:
+    static constexpr int numLayers = 5;
+
+    // Each layer's colour alpha and blur radius, innermost first
+    static const float layerOpacities[numLayers];
+    static const int layerBlurRadii[numLayers];
+
+    // The gradient's stops: position along the radius, alpha multiplier
+    static constexpr float gradientStops[][2] = {
+        { 0.0f, 1.0f }, { 0.3f, 0.9f }, { 0.5f, 0.6f }, { 0.7f, 0.3f }, { 0.9f, 0.1f }, { 1.0f, 0.0f }
+    };
+
+    // The unblurred disc, glowSize across, centred in an ARGB image with a
+    // blurRadius margin on each side
+    static juce::Image renderGradient(int glowSize, juce::Colour colour, int blurRadius);
+
+    // The finished layer: renderGradient() blurred
+    static juce::Image renderGlow(int glowSize, juce::Colour colour, int blurRadius);
+
+    // Just the finished layer's alpha, as a SingleChannel image to be drawn tinted
+    static juce::Image renderGlowMask(int glowSize, float opacity, int blurRadius);
+
+    // Blurs every channel of an image in place. Taps that fall outside the image
+    // count as zero, as they do for ImageConvolutionKernel.
+    static void applyGaussianBlur(juce::Image& image, int blurRadius);
+
+    // The kernel's taps, summing to 1; the 2D weights are products of these
+    static std::vector<float> createGaussianKernel(int blurRadius);
+};
@@ -0,0 +1,62 @@
+#include "GlowSpriteCache.h"
+#include <iterator>
+
+GlowSpriteCache::GlowSpriteCache(const juce::Image& sourceImage)
+{
+    if (!sourceImage.isValid())
+        return;
+
+    const int width = sourceImage.getWidth();
+    const int height = sourceImage.getHeight();
+
+    for (auto squash : squashFactors)
+    {
+        Sprite sprite;
+        sprite.image = squash == 1.0f ? sourceImage
+                                      : sourceImage.rescaled(width, juce::jmax(1, juce::roundToInt(height * squash)),
+                                                             juce::Graphics::highResamplingQuality);
+        sprite.scaleY = sprite.image.getHeight() / (float)height;
+        sprites.push_back(sprite);
+    }
+
+    // Each mip level is filtered from the one above, so every step is a clean 2:1 reduction
+    auto previous = sourceImage;
+
+    for (int level = 1; level < numMipLevels; ++level)
+    {
+        Sprite sprite;
+        sprite.image = previous.rescaled(juce::jmax(1, previous.getWidth() / 2),
+                                         juce::jmax(1, previous.getHeight() / 2),
+                                         juce::Graphics::highResamplingQuality);
+        sprite.scaleX = sprite.image.getWidth() / (float)width;
+        sprite.scaleY = sprite.image.getHeight() / (float)height;
+        sprites.push_back(sprite);
+
+        previous = sprite.image;
+    }
+}
+
+const GlowSpriteCache::Sprite& GlowSpriteCache::getSpriteFor(float scaleX, float scaleY) const
+{
+    jassert(!isEmpty());
+
+    const size_t numSquashVariants = std::size(squashFactors);
+
+    // Shrinking the whole glow (small pads, breathing at its smallest) uses a mip
+    // level. The larger axis decides, so under comet stretch the stretched X axis
+    // is never magnified from a reduced level; the squash variants cover Y instead.
+    float maxScale = juce::jmax(scaleX, scaleY);
+
+    if (maxScale < 0.375f)
+        return sprites[numSquashVariants + 1];
+
+    if (maxScale < 0.75f)
+        return sprites[numSquashVariants];
+
+    // Otherwise pick the squash variant closest above the wanted Y scale
+    for (size_t i = numSquashVariants; --i > 0;)
+        if (scaleY <= squashFactors[i] * 1.2f)
+            return sprites[i];
+
+    return sprites[0];
+}
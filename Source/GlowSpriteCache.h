@@ -0,0 +1,39 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <vector>
+
+// Pre-filtered copies of one glow layer image, built once at load time.
+// Holds a chain of half-size mip levels plus copies of the full-size image
+// squashed along Y (the comet deformation squashes the local Y axis), so the
+// paint path can always pick a copy whose remaining scale is close to 1 and
+// draw it with cheap bilinear filtering instead of high-quality resampling.
+class GlowSpriteCache
+{
+public:
+    struct Sprite
+    {
+        juce::Image image;
+        float scaleX = 1.0f;  // Size relative to the source image
+        float scaleY = 1.0f;
+    };
+
+    GlowSpriteCache() = default;
+    explicit GlowSpriteCache(const juce::Image& sourceImage);
+
+    bool isEmpty() const { return sprites.empty(); }
+
+    // The full-size image everything else was filtered from
+    const juce::Image& getSourceImage() const  { jassert(!isEmpty()); return sprites.front().image; }
+
+    // Returns the sprite to draw when the source image would be drawn at the
+    // given scale; only the remaining scale (scale / sprite.scale) is resampled
+    const Sprite& getSpriteFor(float scaleX, float scaleY) const;
+
+    static constexpr int numMipLevels = 3;
+    static constexpr float squashFactors[] = { 1.0f, 0.7f, 0.5f };
+
+private:
+    // Full-size squash variants first, followed by the smaller mip levels
+    std::vector<Sprite> sprites;
+};
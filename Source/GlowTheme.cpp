@@ -0,0 +1,90 @@
+#include "GlowTheme.h"
+
+namespace
+{
+    juce::var colourToVar(juce::Colour colour)
+    {
+        return colour.toDisplayString(true);
+    }
+
+    // "AARRGGBB", or "RRGGBB" for an opaque colour, with or without a leading #
+    void readColour(const juce::var& value, juce::Colour& colour)
+    {
+        auto text = value.toString().trim().trimCharactersAtStart("#");
+
+        if (!value.isString() || text.isEmpty() || !text.containsOnly("0123456789abcdefABCDEF"))
+            return;
+
+        colour = juce::Colour::fromString(text.length() <= 6 ? "ff" + text : text);
+    }
+}
+
+bool GlowTheme::operator==(const GlowTheme& other) const
+{
+    return padBackground == other.padBackground
+        && cursor == other.cursor
+        && editorBackground == other.editorBackground
+        && shadow == other.shadow
+        && glowColours == other.glowColours
+        && glowSizes == other.glowSizes;
+}
+
+juce::var GlowTheme::toVar() const
+{
+    juce::var json(new juce::DynamicObject());
+    auto* obj = json.getDynamicObject();
+
+    obj->setProperty("padBackground", colourToVar(padBackground));
+    obj->setProperty("cursor", colourToVar(cursor));
+    obj->setProperty("editorBackground", colourToVar(editorBackground));
+    obj->setProperty("shadow", colourToVar(shadow));
+
+    juce::Array<juce::var> colours, sizes;
+
+    for (int i = 0; i < numLayers; ++i)
+    {
+        colours.add(colourToVar(glowColours[(size_t)i]));
+        sizes.add(glowSizes[(size_t)i]);
+    }
+
+    obj->setProperty("glowColours", colours);
+    obj->setProperty("glowSizes", sizes);
+
+    return json;
+}
+
+GlowTheme GlowTheme::fromVar(const juce::var& json, const GlowTheme& base)
+{
+    auto theme = base;
+
+    if (!json.isObject())
+        return theme;
+
+    readColour(json.getProperty("padBackground", {}), theme.padBackground);
+    readColour(json.getProperty("cursor", {}), theme.cursor);
+    readColour(json.getProperty("editorBackground", {}), theme.editorBackground);
+    readColour(json.getProperty("shadow", {}), theme.shadow);
+
+    // Layers are optional one by one, so a theme can recolour only the inner glow
+    auto colourList = json.getProperty("glowColours", {});
+    auto sizeList = json.getProperty("glowSizes", {});
+
+    if (auto* colours = colourList.getArray())
+    {
+        for (int i = 0; i < juce::jmin(numLayers, colours->size()); ++i)
+            readColour(colours->getReference(i), theme.glowColours[(size_t)i]);
+    }
+
+    if (auto* sizes = sizeList.getArray())
+    {
+        for (int i = 0; i < juce::jmin(numLayers, sizes->size()); ++i)
+        {
+            auto& value = sizes->getReference(i);
+
+            if (value.isInt() || value.isInt64() || value.isDouble())
+                theme.glowSizes[(size_t)i] = juce::jlimit(minGlowSize, maxGlowSize, (int)value);
+        }
+    }
+
+    return theme;
+}
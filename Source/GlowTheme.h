@@ -0,0 +1,32 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <array>
+
+// The look of the pad: its colours and the sizes of its five glow layers.
+// The built-in presets are themes, and a preset file can carry any other one.
+// Glow colours are applied as a tint while compositing, so a new theme never
+// needs new glow images; each size picks the nearest baked mask and scales it.
+struct GlowTheme
+{
+    static constexpr int numLayers = 5;
+
+    juce::Colour padBackground;
+    juce::Colour cursor;
+    juce::Colour editorBackground;                      // Around the pad
+    juce::Colour shadow;                                // Drop shadow under the pad
+    std::array<juce::Colour, numLayers> glowColours;    // Innermost first; alpha is ignored
+    std::array<int, numLayers> glowSizes {};            // Glow diameters in pixels, innermost first
+
+    bool operator==(const GlowTheme& other) const;
+    bool operator!=(const GlowTheme& other) const { return !operator==(other); }
+
+    // { "padBackground": "FFFFFFFF", ..., "glowColours": [ ... ], "glowSizes": [ ... ] }
+    juce::var toVar() const;
+
+    // Reads what toVar() writes. Anything missing or malformed keeps its value from base.
+    static GlowTheme fromVar(const juce::var& json, const GlowTheme& base);
+
+    static constexpr int minGlowSize = 16;
+    static constexpr int maxGlowSize = 1024;
+};
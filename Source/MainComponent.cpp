@@ -5,6 +5,9 @@ MainComponent::MainComponent()
     setSize(368, 368);  // 30% smaller than previous
     addAndMakeVisible(xyControl);
 
+    // The pad is opaque, so the editor only repaints around it when asked
+    xyControl.onThemeChanged = [this] { repaint(); };
+
     presetsFolder = NativeDialogs::getPresetsFolder();
 }
 
@@ -14,53 +17,16 @@ MainComponent::~MainComponent()
 
 void MainComponent::paint(juce::Graphics& g)
 {
-    auto preset = xyControl.getCurrentPreset();
-
-    // Fill background with color matching the preset
-    juce::Colour backgroundColor;
-    juce::Colour borderColor;
-
-    if (preset == XYControlComponent::Preset::Blue)
-    {
-        backgroundColor = juce::Colours::white;
-        borderColor = juce::Colours::black;
-    }
-    else if (preset == XYControlComponent::Preset::Red)
-    {
-        backgroundColor = juce::Colour(0xFFFF0000);  // Red
-        borderColor = juce::Colours::black;
-    }
-    else // Black
-    {
-        backgroundColor = juce::Colour(0xFF0A0A0A);  // Very dark gray instead of pure black
-        borderColor = juce::Colours::white;
-    }
-
-    g.fillAll(backgroundColor);
-
-    // Subtle drop shadow for depth (Apple-style)
-    auto controlBounds = xyControl.getBounds().toFloat();
-    float cornerRadius = 24.0f;
-
-    juce::Path shadowPath;
-    shadowPath.addRoundedRectangle(controlBounds, cornerRadius);
-
-    // Use appropriate shadow based on preset - all use dark shadows for uniformity
-    juce::Colour shadowColor;
-    if (preset == XYControlComponent::Preset::Blue)
-        shadowColor = juce::Colour(0x14000000);  // Subtle dark on white
-    else if (preset == XYControlComponent::Preset::Red)
-        shadowColor = juce::Colour(0x30000000);  // Darker on red
-    else // Black
-        shadowColor = juce::Colour(0x40000000);  // Dark shadow on very dark gray (barely visible but maintains uniformity)
-
-    juce::DropShadow shadow(shadowColor, 18, juce::Point<int>(0, 4));
-    shadow.drawForPath(g, shadowPath);
+    // Background and drop shadow, re-rendered only when the layout or theme changes
+    backdrop.paint(g, getLocalBounds());
 
     // Draw blue progress ring during hold (stays glued to border)
     // Only show after brief delay to avoid flashing on quick double-clicks
     if (holdProgress > 0.07f)  // ~200ms delay before becoming visible
     {
+        auto controlBounds = xyControl.getBounds().toFloat();
+        float cornerRadius = xyControl.getCornerRadius();
+
         // Adjust progress to start from 0 after the delay
         float adjustedProgress = (holdProgress - 0.07f) / 0.93f;
 
@@ -101,6 +67,7 @@ void MainComponent::mouseUp(const juce::MouseEvent& event)
 {
     isHoldingOutside = false;
     holdProgress = 0.0f;
+    backdrop.setPadUnderlayEnabled(true);
     stopTimer();
     repaint();
 }
@@ -126,12 +93,16 @@ void MainComponent::timerCallback()
 
         // Update hold progress for visual feedback (0.0 to 1.0)
         holdProgress = juce::jmin(1.0f, holdDuration / 3000.0f);
+
+        // The ring crosses the pad's corners, which an opaque pad would cover
+        backdrop.setPadUnderlayEnabled(holdProgress <= 0.07f);
         repaint();
 
         if (holdDuration >= 3000)  // 3 seconds
         {
             menuShown = true;
             holdProgress = 0.0f;
+            backdrop.setPadUnderlayEnabled(true);
             stopTimer();
             repaint();
             showPresetOptions();
@@ -185,6 +156,7 @@ void MainComponent::savePresetToFile(const juce::File& file)
     obj->setProperty("x", position.x);
     obj->setProperty("y", position.y);
     obj->setProperty("preset", presetIndex);
+    obj->setProperty("theme", xyControl.getTheme().toVar());
 
     // Write to file
     juce::String jsonString = juce::JSON::toString(presetData, true);
@@ -213,6 +185,11 @@ void MainComponent::loadPresetFromFile(const juce::File& file)
 
         // Apply preset
         xyControl.setPreset(static_cast<XYControlComponent::Preset>(presetIndex));
+
+        // Custom colours and glow sizes, on top of the preset's
+        if (obj->hasProperty("theme"))
+            xyControl.setTheme(GlowTheme::fromVar(obj->getProperty("theme"), xyControl.getTheme()));
+
         xyControl.setPosition(x, y);
 
         // Show confirmation
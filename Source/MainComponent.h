@@ -2,6 +2,7 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include "XYControlComponent.h"
+#include "EditorBackdrop.h"
 #include "NativeDialogs.h"
 
 class MainComponent : public juce::Component,
@@ -24,6 +25,7 @@ private:
     void loadPresetFromFile(const juce::File& file);
 
     XYControlComponent xyControl;
+    EditorBackdrop backdrop { xyControl };
 
     bool isHoldingOutside = false;
     int64_t holdStartTime = 0;
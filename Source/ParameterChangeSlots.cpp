@@ -0,0 +1,41 @@
+#include "ParameterChangeSlots.h"
+
+ParameterChangeSlots::ParameterChangeSlots(std::vector<juce::AudioProcessorParameter*> parametersToWatch)
+    : parameters(std::move(parametersToWatch)),
+      slots(parameters.size())
+{
+    for (auto* parameter : parameters)
+        parameter->addListener(this);
+}
+
+ParameterChangeSlots::~ParameterChangeSlots()
+{
+    for (auto* parameter : parameters)
+        parameter->removeListener(this);
+}
+
+void ParameterChangeSlots::parameterValueChanged(int parameterIndex, float newValue)
+{
+    auto index = findParameter(parameterIndex);
+
+    if (index < 0)
+        return;
+
+    // The UI's own edits are made on the message thread, so numEdits is only
+    // worth reading there
+    if (juce::MessageManager::existsAndIsCurrentThread() && numEdits > 0)
+        return;
+
+    auto& slot = slots[(size_t)index];
+    slot.value.store(newValue, std::memory_order_relaxed);
+    slot.dirty.store(true, std::memory_order_release);
+}
+
+int ParameterChangeSlots::findParameter(int parameterIndex) const
+{
+    for (size_t i = 0; i < parameters.size(); ++i)
+        if (parameters[i]->getParameterIndex() == parameterIndex)
+            return (int)i;
+
+    return -1;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <atomic>
+#include <vector>
+
+// Carries parameter changes made by the host (automation, another controller,
+// a generic editor) to the UI. Each watched parameter has one slot: an atomic
+// value and dirty flag. Any thread can fill a slot without locking or
+// allocating, and a later change simply overwrites an earlier one; the UI
+// drains the dirty slots once per frame and sees only the latest value of each
+// parameter.
+//
+// The UI's own edits go through a ScopedEdit and aren't reported back to it.
+class ParameterChangeSlots : private juce::AudioProcessorParameter::Listener
+{
+public:
+    explicit ParameterChangeSlots(std::vector<juce::AudioProcessorParameter*> parametersToWatch);
+    ~ParameterChangeSlots() override;
+
+    // Calls back on the message thread with (index into parametersToWatch,
+    // normalised value) for each parameter that changed since the last call
+    template <typename Callback>
+    void drain(Callback&& callback)
+    {
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        for (size_t i = 0; i < parameters.size(); ++i)
+            if (slots[i].dirty.exchange(false, std::memory_order_acquire))
+                callback((int)i, slots[i].value.load(std::memory_order_relaxed));
+    }
+
+    // Changes made while one of these exists on the message thread are the
+    // UI's own, and aren't reported so they don't echo back
+    struct ScopedEdit
+    {
+        explicit ScopedEdit(ParameterChangeSlots& s) : owner(s) { ++owner.numEdits; }
+        ~ScopedEdit() { --owner.numEdits; }
+
+        ParameterChangeSlots& owner;
+    };
+
+private:
+    struct Slot
+    {
+        std::atomic<float> value { 0.0f };
+        std::atomic<bool> dirty { false };
+    };
+
+    void parameterValueChanged(int parameterIndex, float newValue) override;
+    void parameterGestureChanged(int, bool) override {}
+    int findParameter(int parameterIndex) const;
+
+    std::vector<juce::AudioProcessorParameter*> parameters;
+
+    // Written by whichever thread changed the parameter, read by the message thread
+    std::vector<Slot> slots;
+
+    // Message thread only
+    int numEdits = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ParameterChangeSlots)
+};
@@ -7,68 +7,40 @@ XYControlAudioProcessorEditor::XYControlAudioProcessorEditor(XYControlAudioProce
     setSize(368, 368);  // Match standalone app size
     addAndMakeVisible(xyControl);
 
+    // The pad is opaque, so the editor only repaints around it when asked
+    xyControl.onThemeChanged = [this] { repaint(); };
+
     presetsFolder = NativeDialogs::getPresetsFolder();
 
-    // Set initial position from parameters
+    // Set initial position and look from parameters
     xyControl.setPosition(*audioProcessor.xParam, *audioProcessor.yParam);
-    xyControl.setPreset(static_cast<XYControlComponent::Preset>((int)*audioProcessor.presetParam));
+    showPresetFromState();
 
-    startTimerHz(30);  // Update parameters regularly
+    // Edits reach the host as they happen, inside gestures, rather than being polled
+    xyControl.addListener(this);
 }
 
 XYControlAudioProcessorEditor::~XYControlAudioProcessorEditor()
 {
+    // Closed mid-drag: the host would otherwise leave X and Y in touch mode
+    if (xyControl.isGestureInProgress())
+        xyGestureEnded(xyControl);
+
+    xyControl.removeListener(this);
 }
 
 void XYControlAudioProcessorEditor::paint(juce::Graphics& g)
 {
-    auto preset = xyControl.getCurrentPreset();
-
-    // Fill background with color matching the preset
-    juce::Colour backgroundColor;
-    juce::Colour borderColor;
-
-    if (preset == XYControlComponent::Preset::Blue)
-    {
-        backgroundColor = juce::Colours::white;
-        borderColor = juce::Colours::black;
-    }
-    else if (preset == XYControlComponent::Preset::Red)
-    {
-        backgroundColor = juce::Colour(0xFFFF0000);  // Red
-        borderColor = juce::Colours::black;
-    }
-    else // Black
-    {
-        backgroundColor = juce::Colour(0xFF0A0A0A);  // Very dark gray instead of pure black
-        borderColor = juce::Colours::white;
-    }
-
-    g.fillAll(backgroundColor);
-
-    // Subtle drop shadow for depth (Apple-style)
-    auto controlBounds = xyControl.getBounds().toFloat();
-    float cornerRadius = 24.0f;
-
-    juce::Path shadowPath;
-    shadowPath.addRoundedRectangle(controlBounds, cornerRadius);
-
-    // Use appropriate shadow based on preset - all use dark shadows for uniformity
-    juce::Colour shadowColor;
-    if (preset == XYControlComponent::Preset::Blue)
-        shadowColor = juce::Colour(0x14000000);  // Subtle dark on white
-    else if (preset == XYControlComponent::Preset::Red)
-        shadowColor = juce::Colour(0x30000000);  // Darker on red
-    else // Black
-        shadowColor = juce::Colour(0x40000000);  // Dark shadow on very dark gray (barely visible but maintains uniformity)
-
-    juce::DropShadow shadow(shadowColor, 18, juce::Point<int>(0, 4));
-    shadow.drawForPath(g, shadowPath);
+    // Background and drop shadow, re-rendered only when the layout or theme changes
+    backdrop.paint(g, getLocalBounds());
 
     // Draw blue progress ring during hold (stays glued to border)
     // Only show after brief delay to avoid flashing on quick double-clicks
     if (holdProgress > 0.07f)  // ~200ms delay before becoming visible
     {
+        auto controlBounds = xyControl.getBounds().toFloat();
+        float cornerRadius = xyControl.getCornerRadius();
+
         // Adjust progress to start from 0 after the delay
         float adjustedProgress = (holdProgress - 0.07f) / 0.93f;
 
@@ -108,6 +80,7 @@ void XYControlAudioProcessorEditor::mouseUp(const juce::MouseEvent& event)
 {
     isHoldingOutside = false;
     holdProgress = 0.0f;
+    backdrop.setPadUnderlayEnabled(true);
     stopTimer();
     repaint();
 }
@@ -119,15 +92,107 @@ void XYControlAudioProcessorEditor::mouseDoubleClick(const juce::MouseEvent& eve
         auto currentPreset = static_cast<int>(xyControl.getCurrentPreset());
         currentPreset = (currentPreset + 1) % 3;
         xyControl.setPreset(static_cast<XYControlComponent::Preset>(currentPreset));
-        *audioProcessor.presetParam = currentPreset;
+        publishEdit(*audioProcessor.presetParam, (float)currentPreset);
+
+        audioProcessor.clearCustomThemeUnlessBasedOn(currentPreset);
+        shownCustomThemeVersion = audioProcessor.getCustomThemeVersion();
     }
 }
 
-void XYControlAudioProcessorEditor::timerCallback()
+// Sets a parameter only if its value actually changes, so the host's automation
+// and undo history don't fill up with repeats
+static void setIfChanged(juce::RangedAudioParameter& parameter, float value)
+{
+    auto normalised = parameter.convertTo0to1(value);
+
+    if (normalised != parameter.getValue())
+        parameter.setValueNotifyingHost(normalised);
+}
+
+void XYControlAudioProcessorEditor::xyGestureStarted(XYControlComponent&)
 {
-    // Update parameters from XY control
-    updateParametersFromXY();
+    audioProcessor.xParam->beginChangeGesture();
+    audioProcessor.yParam->beginChangeGesture();
+}
+
+void XYControlAudioProcessorEditor::xyPositionChanged(XYControlComponent&, juce::Point<float> newPosition)
+{
+    ParameterChangeSlots::ScopedEdit edit(hostChanges);
+    setIfChanged(*audioProcessor.xParam, newPosition.x);
+    setIfChanged(*audioProcessor.yParam, newPosition.y);
+}
 
+void XYControlAudioProcessorEditor::xyGestureEnded(XYControlComponent&)
+{
+    audioProcessor.xParam->endChangeGesture();
+    audioProcessor.yParam->endChangeGesture();
+}
+
+// A one-off edit, such as a preset change, wrapped in its own gesture
+void XYControlAudioProcessorEditor::publishEdit(juce::RangedAudioParameter& parameter, float value)
+{
+    if (parameter.convertTo0to1(value) == parameter.getValue())
+        return;
+
+    ParameterChangeSlots::ScopedEdit edit(hostChanges);
+    parameter.beginChangeGesture();
+    setIfChanged(parameter, value);
+    parameter.endChangeGesture();
+}
+
+// The host's preset, with the custom theme on top if it was loaded for that preset
+void XYControlAudioProcessorEditor::showPresetFromState()
+{
+    auto preset = (int)*audioProcessor.presetParam;
+    audioProcessor.clearCustomThemeUnlessBasedOn(preset);
+
+    shownCustomThemeVersion = audioProcessor.getCustomThemeVersion();
+    auto customTheme = audioProcessor.getCustomTheme();
+
+    xyControl.setPreset(static_cast<XYControlComponent::Preset>(preset));
+
+    if (customTheme.json.isNotEmpty())
+        xyControl.setTheme(GlowTheme::fromVar(juce::JSON::parse(customTheme.json), xyControl.getTheme()));
+}
+
+void XYControlAudioProcessorEditor::applyHostChanges()
+{
+    // A restored state may have brought another custom theme
+    if (audioProcessor.getCustomThemeVersion() != shownCustomThemeVersion)
+        showPresetFromState();
+
+    auto position = xyControl.getPosition();
+    bool positionChanged = false;
+
+    hostChanges.drain([&](int index, float value)
+    {
+        if (index == 2)
+        {
+            auto preset = juce::roundToInt(audioProcessor.presetParam->convertFrom0to1(value));
+
+            // Automation or an echo of the preset the custom theme is based on keeps it up
+            if (preset != static_cast<int>(xyControl.getCurrentPreset()))
+            {
+                xyControl.setPreset(static_cast<XYControlComponent::Preset>(preset));
+                audioProcessor.clearCustomThemeUnlessBasedOn(preset);
+                shownCustomThemeVersion = audioProcessor.getCustomThemeVersion();
+            }
+
+            return;
+        }
+
+        auto& parameter = index == 0 ? *audioProcessor.xParam : *audioProcessor.yParam;
+        (index == 0 ? position.x : position.y) = parameter.convertFrom0to1(value);
+        positionChanged = true;
+    });
+
+    // While the user holds the pad their drag wins over automation
+    if (positionChanged && !xyControl.isGestureInProgress())
+        xyControl.setTargetPosition(position.x, position.y);
+}
+
+void XYControlAudioProcessorEditor::timerCallback()
+{
     // Handle hold progress
     if (isHoldingOutside && !menuShown)
     {
@@ -135,12 +200,16 @@ void XYControlAudioProcessorEditor::timerCallback()
         int64_t holdDuration = currentTime - holdStartTime;
 
         holdProgress = juce::jmin(1.0f, holdDuration / 3000.0f);
+
+        // The ring crosses the pad's corners, which an opaque pad would cover
+        backdrop.setPadUnderlayEnabled(holdProgress <= 0.07f);
         repaint();
 
         if (holdDuration >= 3000)
         {
             menuShown = true;
             holdProgress = 0.0f;
+            backdrop.setPadUnderlayEnabled(true);
             stopTimer();
             repaint();
             showPresetOptions();
@@ -148,14 +217,6 @@ void XYControlAudioProcessorEditor::timerCallback()
     }
 }
 
-void XYControlAudioProcessorEditor::updateParametersFromXY()
-{
-    auto position = xyControl.getPosition();
-    *audioProcessor.xParam = position.x;
-    *audioProcessor.yParam = position.y;
-    *audioProcessor.presetParam = static_cast<int>(xyControl.getCurrentPreset());
-}
-
 void XYControlAudioProcessorEditor::showPresetOptions()
 {
     NativeDialogs::showPresetMenu([this](int result)
@@ -195,6 +256,7 @@ void XYControlAudioProcessorEditor::savePresetToFile(const juce::File& file)
     obj->setProperty("x", position.x);
     obj->setProperty("y", position.y);
     obj->setProperty("preset", presetIndex);
+    obj->setProperty("theme", xyControl.getTheme().toVar());
 
     juce::String jsonString = juce::JSON::toString(presetData, true);
     file.replaceWithText(jsonString);
@@ -217,11 +279,24 @@ void XYControlAudioProcessorEditor::loadPresetFromFile(const juce::File& file)
         int presetIndex = obj->getProperty("preset");
 
         xyControl.setPreset(static_cast<XYControlComponent::Preset>(presetIndex));
+
+        // Custom colours and glow sizes, on top of the preset's, kept in the plugin's state
+        XYControlAudioProcessor::CustomTheme customTheme;
+
+        if (obj->hasProperty("theme"))
+        {
+            xyControl.setTheme(GlowTheme::fromVar(obj->getProperty("theme"), xyControl.getTheme()));
+            customTheme = { juce::JSON::toString(xyControl.getTheme().toVar(), true), presetIndex };
+        }
+
+        audioProcessor.setCustomTheme(customTheme);
+        shownCustomThemeVersion = audioProcessor.getCustomThemeVersion();
+
         xyControl.setPosition(x, y);
 
-        *audioProcessor.xParam = x;
-        *audioProcessor.yParam = y;
-        *audioProcessor.presetParam = presetIndex;
+        publishEdit(*audioProcessor.xParam, x);
+        publishEdit(*audioProcessor.yParam, y);
+        publishEdit(*audioProcessor.presetParam, (float)presetIndex);
 
         NativeDialogs::showConfirmation("Preset Loaded",
             "Loaded preset from " + file.getFileName(), [](){});
@@ -3,9 +3,12 @@
 #include <juce_audio_processors/juce_audio_processors.h>
 #include "PluginProcessor.h"
 #include "XYControlComponent.h"
+#include "EditorBackdrop.h"
 #include "NativeDialogs.h"
+#include "ParameterChangeSlots.h"
 
 class XYControlAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                       private XYControlComponent::Listener,
                                        private juce::Timer
 {
 public:
@@ -19,14 +22,26 @@ public:
     void mouseDoubleClick(const juce::MouseEvent& event) override;
 
 private:
+    void xyGestureStarted(XYControlComponent&) override;
+    void xyPositionChanged(XYControlComponent&, juce::Point<float> newPosition) override;
+    void xyGestureEnded(XYControlComponent&) override;
+
     void timerCallback() override;
     void showPresetOptions();
     void savePresetToFile(const juce::File& file);
     void loadPresetFromFile(const juce::File& file);
-    void updateParametersFromXY();
+    void publishEdit(juce::RangedAudioParameter& parameter, float value);
+    void applyHostChanges();
+    void showPresetFromState();
 
     XYControlAudioProcessor& audioProcessor;
     XYControlComponent xyControl;
+    EditorBackdrop backdrop { xyControl };
+
+    // Host changes to x, y and preset, in that order, drained once per refresh
+    ParameterChangeSlots hostChanges { { audioProcessor.xParam, audioProcessor.yParam, audioProcessor.presetParam } };
+    juce::VBlankAttachment hostChangeDrain { this, [this] { applyHostChanges(); } };
+    int shownCustomThemeVersion = -1;
 
     bool isHoldingOutside = false;
     int64_t holdStartTime = 0;
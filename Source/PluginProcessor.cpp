@@ -65,6 +65,8 @@ void XYControlAudioProcessor::changeProgramName(int index, const juce::String& n
 
 void XYControlAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+    modulation.prepare(sampleRate, samplesPerBlock);
+    modulation.reset(*xParam, *yParam);
 }
 
 void XYControlAudioProcessor::releaseResources()
@@ -89,6 +91,16 @@ void XYControlAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juc
 
     // Pass-through audio (no processing)
     // The XY control is just for UI/parameter control
+
+    // Smoothed here rather than in the UI, so it doesn't depend on the editor being open.
+    // While the transport runs the smoothing follows the timeline, so a bounce
+    // matches playback from the same point.
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition())
+            if (auto timeInSamples = position->getTimeInSamples(); timeInSamples && position->getIsPlaying())
+                modulation.syncToTimeline(*timeInSamples);
+
+    modulation.process(*xParam, *yParam, buffer.getNumSamples());
 }
 
 bool XYControlAudioProcessor::hasEditor() const
@@ -101,6 +113,30 @@ juce::AudioProcessorEditor* XYControlAudioProcessor::createEditor()
     return new XYControlAudioProcessorEditor(*this);
 }
 
+XYControlAudioProcessor::CustomTheme XYControlAudioProcessor::getCustomTheme() const
+{
+    const juce::ScopedLock lock(customThemeLock);
+    return customTheme;
+}
+
+void XYControlAudioProcessor::setCustomTheme(const CustomTheme& newTheme)
+{
+    const juce::ScopedLock lock(customThemeLock);
+    customTheme = newTheme;
+    ++customThemeVersion;
+}
+
+void XYControlAudioProcessor::clearCustomThemeUnlessBasedOn(int preset)
+{
+    const juce::ScopedLock lock(customThemeLock);
+
+    if (customTheme.json.isEmpty() || customTheme.basePreset == preset)
+        return;
+
+    customTheme = {};
+    ++customThemeVersion;
+}
+
 void XYControlAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
     // Save state
@@ -108,15 +144,34 @@ void XYControlAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
     stream.writeFloat(*xParam);
     stream.writeFloat(*yParam);
     stream.writeInt(*presetParam);
+
+    auto theme = getCustomTheme();
+    stream.writeString(theme.json);
+    stream.writeInt(theme.basePreset);
 }
 
 void XYControlAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
     // Load state
     juce::MemoryInputStream stream(data, static_cast<size_t>(sizeInBytes), false);
-    *xParam = stream.readFloat();
-    *yParam = stream.readFloat();
-    *presetParam = stream.readInt();
+    auto x = stream.readFloat();
+    auto y = stream.readFloat();
+    auto preset = stream.readInt();
+
+    // States saved before custom themes were kept end here
+    CustomTheme theme;
+
+    if (!stream.isExhausted())
+    {
+        theme.json = stream.readString();
+        theme.basePreset = stream.readInt();
+    }
+
+    // The theme goes first, so the editor never sees the new preset against the old theme and drops it
+    setCustomTheme(theme);
+    *xParam = x;
+    *yParam = y;
+    *presetParam = preset;
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <juce_audio_processors/juce_audio_processors.h>
+#include "XYModulation.h"
 
 class XYControlAudioProcessor : public juce::AudioProcessor
 {
@@ -36,6 +37,35 @@ public:
     juce::AudioParameterFloat* yParam;
     juce::AudioParameterInt* presetParam;
 
+    // A theme loaded from a preset file, as GlowTheme JSON, drawn on top of the
+    // preset it was loaded with. It's saved with the plugin's state, and only
+    // dropped once presetParam really moves away from that preset.
+    struct CustomTheme
+    {
+        juce::String json;      // Empty for none
+        int basePreset = 0;
+    };
+
+    CustomTheme getCustomTheme() const;
+    void setCustomTheme(const CustomTheme& newTheme);
+    void clearCustomThemeUnlessBasedOn(int preset);
+
+    // Changes whenever the custom theme does, e.g. when the host restores a state
+    int getCustomThemeVersion() const { return customThemeVersion.load(); }
+
+    // X (channel 0) and Y (channel 1) smoothed at audio rate, for anything
+    // downstream to read. Holds the current block during processBlock(), and
+    // the last block after it.
+    const juce::AudioBuffer<float>& getModulationBuffer() const { return modulation.getBuffer(); }
+    XYModulation& getModulation() { return modulation; }
+
 private:
+    XYModulation modulation;
+
+    // Set from the message thread, read by whichever thread saves the state
+    juce::CriticalSection customThemeLock;
+    CustomTheme customTheme;
+    std::atomic<int> customThemeVersion { 0 };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XYControlAudioProcessor)
 };
@@ -0,0 +1,73 @@
+#include "PointerInputQueue.h"
+
+void PointerInputQueue::push(const Sample& sample)
+{
+    newest = (newest + 1) % capacity;
+    samples[(size_t)newest] = sample;
+
+    // When full, the oldest sample is overwritten, popped or not
+    numSamples = juce::jmin(numSamples + 1, capacity);
+    numPending = juce::jmin(numPending + 1, capacity);
+}
+
+void PointerInputQueue::clear()
+{
+    numSamples = 0;
+    numPending = 0;
+}
+
+std::optional<PointerInputQueue::Sample> PointerInputQueue::popUpTo(double timeMs)
+{
+    std::optional<Sample> latest;
+
+    while (numPending > 0 && getSample(numPending - 1).timeMs <= timeMs)
+        latest = getSample(--numPending);
+
+    return latest;
+}
+
+juce::Point<float> PointerInputQueue::predictPositionAt(double timeMs) const
+{
+    if (numSamples == 0)
+        return {};
+
+    auto& last = getSample(0);
+    juce::Point<float> position { last.x, last.y };
+
+    // Least-squares velocity over the recent samples, times relative to the newest
+    double sumT = 0.0, sumTT = 0.0, sumX = 0.0, sumTX = 0.0, sumY = 0.0, sumTY = 0.0;
+    int count = 0;
+
+    for (int age = 0; age < numSamples; ++age)
+    {
+        auto& sample = getSample(age);
+        auto t = sample.timeMs - last.timeMs;
+
+        if (t < -velocityWindowMs)
+            break;
+
+        sumT += t;
+        sumTT += t * t;
+        sumX += sample.x;
+        sumTX += t * sample.x;
+        sumY += sample.y;
+        sumTY += t * sample.y;
+        ++count;
+    }
+
+    auto denominator = count * sumTT - sumT * sumT;
+
+    if (count < 2 || denominator <= 0.0)
+        return position;
+
+    auto velocityX = (count * sumTX - sumT * sumX) / denominator;
+    auto velocityY = (count * sumTY - sumT * sumY) / denominator;
+    auto ageMs = timeMs - last.timeMs;
+    auto lookAheadMs = juce::jlimit(0.0, maxPredictionMs, ageMs);
+
+    // A pointer that stops sending samples has stopped moving, so once the newest
+    // one is older than the velocity window the prediction eases back onto it
+    lookAheadMs *= juce::jlimit(0.0, 1.0, 2.0 - ageMs / velocityWindowMs);
+
+    return position + juce::Point<float>((float)(velocityX * lookAheadMs), (float)(velocityY * lookAheadMs));
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <array>
+#include <optional>
+
+// Pointer positions in the order they arrived, each stamped with its time. The
+// pad's physics takes every one at the step it belongs to, rather than only
+// the last one before each frame, and the recent ones give the pointer's
+// velocity for predicting where it will be.
+class PointerInputQueue
+{
+public:
+    struct Sample
+    {
+        float x = 0.0f, y = 0.0f;   // Relative to the pad's size
+        double timeMs = 0.0;        // On the pad's animation timeline, which the physics steps follow
+        double arrivalMs = 0.0;     // On FrameClock::getTimeMs()'s clock, for measuring latency
+    };
+
+    void push(const Sample& sample);
+    void clear();
+
+    bool hasPending() const { return numPending > 0; }
+
+    // Removes the samples that arrived up to the given time and returns the
+    // latest of them, or nothing if none had
+    std::optional<Sample> popUpTo(double timeMs);
+
+    // Where the pointer will be at the given time, extrapolated (by at most
+    // maxPredictionMs) from its velocity over the last velocityWindowMs of samples.
+    // The extrapolation fades out as the newest sample ages past velocityWindowMs,
+    // and is gone at twice that, so a held pointer is followed to where it is.
+    juce::Point<float> predictPositionAt(double timeMs) const;
+
+    static constexpr int capacity = 64;
+    static constexpr double velocityWindowMs = 48.0;
+    static constexpr double maxPredictionMs = 32.0;
+
+private:
+    const Sample& getSample(int age) const { return samples[(size_t)((newest - age + capacity) % capacity)]; }
+
+    // A ring of the most recent samples, numPending of which (the newest) haven't been popped yet
+    std::array<Sample, capacity> samples;
+    int newest = capacity - 1;
+    int numSamples = 0;
+    int numPending = 0;
+};
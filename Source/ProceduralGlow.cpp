@@ -0,0 +1,149 @@
+#include "ProceduralGlow.h"
+#include "GlowCompositorKernel.h"
+#include "GlowRasterizer.h"
+#include <iterator>
+
+ProceduralGlow::Profile ProceduralGlow::createProfile(int size, int blurRadius, float colourAlpha)
+{
+    const auto& stops = GlowRasterizer::gradientStops;
+    const float radius = size / 2.0f;
+
+    auto gradientAt = [&](float distance)
+    {
+        float t = distance / radius;
+
+        for (size_t i = 1; i < std::size(stops); ++i)
+            if (t <= stops[i][0])
+                return juce::jmap(t, stops[i - 1][0], stops[i][0], stops[i - 1][1], stops[i][1]);
+
+        return 0.0f;
+    };
+
+    // The 2D blur weights are products of these
+    const auto kernel = GlowRasterizer::createGaussianKernel(blurRadius);
+    const int taps = (int)kernel.size();
+    const int centre = taps / 2;
+
+    Profile profile;
+    profile.maxRadius = radius + (float)blurRadius;
+    profile.alpha.resize((size_t)profileResolution + 1, 0.0f);
+
+    for (int n = 0; n < profileResolution; ++n)
+    {
+        float distance = profile.maxRadius * (float)n / (float)(profileResolution - 1);
+        float total = 0.0f;
+
+        for (int ky = 0; ky < taps; ++ky)
+            for (int kx = 0; kx < taps; ++kx)
+                total += kernel[(size_t)kx] * kernel[(size_t)ky]
+                       * gradientAt(std::hypot(distance + (float)(kx - centre), (float)(ky - centre)));
+
+        profile.alpha[(size_t)n] = total * colourAlpha;
+    }
+
+    return profile;
+}
+
+void ProceduralGlow::render(GlowCompositor::Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+                            const Layer* layers, int numLayers)
+{
+    Pass pass(backend, destination, area, layers, numLayers);
+    pass.render(pass.getArea());
+}
+
+//==============================================================================
+ProceduralGlow::Pass::Pass(GlowCompositor::Backend backendToUse, juce::Image& destination, juce::Rectangle<int> areaToRender,
+                           const Layer* layers, int numLayers, std::optional<juce::Colour> backgroundColour)
+    : backend(backendToUse),
+      area(areaToRender.getIntersection(destination.getBounds())),
+      background(backgroundColour)
+{
+    jassert(destination.getFormat() == juce::Image::ARGB);
+    jassert(numLayers <= GlowCompositor::maxLayers);
+
+    // There's no JUCE drawing path for a procedural glow
+    if (!GlowCompositor::isBackendAvailable(backend) || backend == GlowCompositor::Backend::Juce)
+        backend = GlowCompositor::Backend::Scalar;
+
+    if (area.isEmpty())
+        return;
+
+    for (int i = 0; i < juce::jmin(numLayers, GlowCompositor::maxLayers); ++i)
+    {
+        auto& layer = layers[i];
+
+        if (layer.profile == nullptr || layer.profile->isEmpty() || layer.opacity <= 0.0f
+            || layer.transform.isSingularity())
+            continue;
+
+        auto maxRadius = layer.profile->maxRadius;
+        auto bounds = juce::Rectangle<float>(-maxRadius, -maxRadius, maxRadius * 2.0f, maxRadius * 2.0f)
+                          .transformedBy(layer.transform)
+                          .getSmallestIntegerContainer().expanded(1).getIntersection(area);
+
+        if (bounds.isEmpty())
+            continue;
+
+        auto inverse = layer.transform.inverted();
+        auto opacity = juce::jmin(1.0f, layer.opacity);
+
+        auto& setup = setups[(size_t)numSetups++];
+        setup.profile = layer.profile->alpha.data();
+        setup.profileScale = (float)(profileResolution - 1) / maxRadius;
+        setup.maxIndex = (float)(profileResolution - 1);
+        setup.ux = inverse.mat00;
+        setup.uy = inverse.mat01;
+        setup.u0 = inverse.mat02;
+        setup.vx = inverse.mat10;
+        setup.vy = inverse.mat11;
+        setup.v0 = inverse.mat12;
+        setup.colour[0] = layer.colour.getBlue() * opacity;
+        setup.colour[1] = layer.colour.getGreen() * opacity;
+        setup.colour[2] = layer.colour.getRed() * opacity;
+        setup.colour[3] = 255.0f * opacity;
+        setup.left = bounds.getX();
+        setup.top = bounds.getY();
+        setup.right = bounds.getRight();
+        setup.bottom = bounds.getBottom();
+    }
+
+    destinationData.emplace(destination, juce::Image::BitmapData::readWrite);
+    jassert(destinationData->pixelStride == 4);
+}
+
+void ProceduralGlow::Pass::render(juce::Rectangle<int> tile) const
+{
+    tile = tile.getIntersection(area);
+
+    if (tile.isEmpty())
+        return;
+
+    GlowCompositorDetail::Destination target { destinationData->data, destinationData->lineStride,
+                                               tile.getX(), tile.getY(), tile.getRight(), tile.getBottom() };
+
+    if (background.has_value())
+        GlowCompositorDetail::fillArea(target, background->getPixelARGB().getNativeARGB());
+
+    switch (backend)
+    {
+        case GlowCompositor::Backend::AVX2:
+            GlowCompositorDetail::renderProceduralAVX2(target, setups.data(), numSetups);
+            break;
+
+       #if XYCONTROL_COMPOSITOR_SSE2
+        case GlowCompositor::Backend::SSE2:
+            renderProceduralArea<SSE2Ops>(target, setups.data(), numSetups);
+            break;
+       #endif
+
+       #if XYCONTROL_COMPOSITOR_NEON
+        case GlowCompositor::Backend::NEON:
+            renderProceduralArea<NEONOps>(target, setups.data(), numSetups);
+            break;
+       #endif
+
+        default:
+            renderProceduralArea<ScalarOps>(target, setups.data(), numSetups);
+            break;
+    }
+}
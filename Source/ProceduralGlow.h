@@ -0,0 +1,68 @@
+#pragma once
+
+#include <juce_graphics/juce_graphics.h>
+#include <vector>
+#include "GlowCompositor.h"
+#include "GlowCompositorDetail.h"
+
+// Renders the glow layers analytically instead of sampling the baked PNGs.
+// Each layer's falloff (the generator's radial gradient blurred by its Gaussian
+// kernel) is tabulated once against distance from the centre. Drawing then costs
+// an inverse transform, a square root and a table lookup per pixel per layer,
+// with the comet stretch, squash and rotation applied exactly at any scale.
+class ProceduralGlow
+{
+public:
+    // Alpha (0..1) against distance from the glow centre in image pixels, with
+    // one trailing zero entry so lookups can always read the next value
+    struct Profile
+    {
+        std::vector<float> alpha;
+        float maxRadius = 0.0f;
+
+        bool isEmpty() const { return alpha.empty(); }
+    };
+
+    static constexpr int profileResolution = 256;
+
+    // Matches GlowRasterizer::renderGlow(): a gradient of the given diameter, faded by
+    // colourAlpha and blurred with a blurRadius-tap Gaussian kernel
+    static Profile createProfile(int size, int blurRadius, float colourAlpha);
+
+    struct Layer
+    {
+        const Profile* profile = nullptr;
+        juce::AffineTransform transform;    // Glow space (centre at the origin) to destination space
+        juce::Colour colour;                // Only RGB is used, alpha lives in the profile
+        float opacity = 1.0f;
+    };
+
+    // Blends the layers, back to front, over an ARGB image within area, using
+    // the SIMD kernel of the given compositor backend (JUCE means scalar here)
+    static void render(GlowCompositor::Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+                       const Layer* layers, int numLayers);
+
+    // Prepared render whose area can be split into tiles, and disjoint tiles
+    // rendered concurrently (see GlowCompositor::Pass)
+    class Pass
+    {
+    public:
+        Pass(GlowCompositor::Backend backend, juce::Image& destination, juce::Rectangle<int> area,
+             const Layer* layers, int numLayers, std::optional<juce::Colour> background = {});
+
+        juce::Rectangle<int> getArea() const { return area; }
+
+        void render(juce::Rectangle<int> tile) const;
+
+    private:
+        GlowCompositor::Backend backend;
+        juce::Rectangle<int> area;
+        std::optional<juce::Colour> background;
+
+        std::array<GlowCompositorDetail::ProceduralLayerSetup, GlowCompositor::maxLayers> setups;
+        int numSetups = 0;
+        std::optional<juce::Image::BitmapData> destinationData;
+
+        JUCE_DECLARE_NON_COPYABLE(Pass)
+    };
+};
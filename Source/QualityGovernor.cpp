@@ -0,0 +1,80 @@
+#include "QualityGovernor.h"
+
+void QualityGovernor::setEnabled(bool shouldBeEnabled)
+{
+    enabled = shouldBeEnabled;
+
+    if (!enabled)
+        setLevel(Level::Full);
+}
+
+bool QualityGovernor::addFrame(double paintMs, double nowMs)
+{
+    // Time since the last frame counts towards the level it was painted at
+    if (lastFrameMs > 0.0 && nowMs > lastFrameMs)
+        stats.msAtLevel[(size_t)stats.level] += nowMs - lastFrameMs;
+
+    lastFrameMs = nowMs;
+
+    stats.smoothedPaintMs = stats.smoothedPaintMs <= 0.0
+                                ? paintMs
+                                : stats.smoothedPaintMs + settings.smoothing * (paintMs - stats.smoothedPaintMs);
+
+    if (!enabled)
+        return false;
+
+    framesOverBudget = stats.smoothedPaintMs > settings.frameBudgetMs ? framesOverBudget + 1 : 0;
+    framesWithHeadroom = stats.smoothedPaintMs < settings.frameBudgetMs * settings.stepUpFraction
+                             ? framesWithHeadroom + 1 : 0;
+
+    auto level = (int)stats.level;
+
+    if (framesOverBudget >= settings.framesToStepDown && level < numLevels - 1)
+    {
+        setLevel((Level)(level + 1));
+        ++stats.numStepsDown;
+        return true;
+    }
+
+    if (framesWithHeadroom >= settings.framesToStepUp && level > 0)
+    {
+        setLevel((Level)(level - 1));
+        ++stats.numStepsUp;
+        return true;
+    }
+
+    return false;
+}
+
+void QualityGovernor::setLevel(Level newLevel)
+{
+    stats.level = newLevel;
+
+    // The average still holds the old level's frames, so start it afresh and
+    // give the new level a full run of frames before judging it
+    stats.smoothedPaintMs = 0.0;
+    framesOverBudget = 0;
+    framesWithHeadroom = 0;
+}
+
+void QualityGovernor::resetStats()
+{
+    auto level = stats.level;
+    stats = {};
+    stats.level = level;
+    lastFrameMs = 0.0;
+}
+
+const char* QualityGovernor::getLevelName(Level level)
+{
+    switch (level)
+    {
+        case Level::Full:                return "Full";
+        case Level::FastResampling:      return "Fast resampling";
+        case Level::FewerLayers:         return "Fewer layers";
+        case Level::HalfResolutionOuter: return "Half-resolution outer layers";
+        case Level::SlowBreathing:       return "Slow breathing";
+    }
+
+    return "";
+}
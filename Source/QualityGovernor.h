@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+
+// Holds the pad's paint time within a frame budget when the message thread is
+// busy (a DAW under load). Each painted frame reports how long it took; the
+// governor smooths that and steps the rendering down through progressively
+// cheaper levels while it stays over budget, then back up once there has been
+// plenty of headroom for a while. Going down is quick and going up is slow, with
+// a gap between the two thresholds, so it doesn't flip between two levels.
+class QualityGovernor
+{
+public:
+    // Each level keeps the savings of the ones before it
+    enum class Level
+    {
+        Full = 0,               // As designed
+        FastResampling,         // Glow layers drawn with low-quality resampling (JUCE path)
+        FewerLayers,            // Outermost glow layer left out
+        HalfResolutionOuter,    // Outer glow layers drawn from half-size sprites
+        SlowBreathing           // Idle breathing at half its frame rate
+    };
+
+    static constexpr int numLevels = 5;
+
+    struct Settings
+    {
+        double frameBudgetMs = 8.0;     // Half a 60 Hz frame; the host needs the rest
+        double stepUpFraction = 0.5;    // Headroom means under this fraction of the budget
+        int framesToStepDown = 6;       // Consecutive smoothed frames over budget
+        int framesToStepUp = 120;       // Consecutive smoothed frames with headroom (~2 s)
+        double smoothing = 0.2;         // Weight of the newest frame in the running average
+    };
+
+    struct Stats
+    {
+        Level level = Level::Full;
+        double smoothedPaintMs = 0.0;
+        std::array<double, numLevels> msAtLevel {};     // Wall-clock time spent at each level
+        int numStepsDown = 0;
+        int numStepsUp = 0;
+    };
+
+    void setSettings(const Settings& newSettings) { settings = newSettings; }
+    const Settings& getSettings() const { return settings; }
+
+    // A governor that's disabled stays at Full
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return enabled; }
+
+    // Reports one painted frame and returns true if the level changed
+    bool addFrame(double paintMs, double nowMs);
+
+    Level getLevel() const { return stats.level; }
+    bool isAtLeast(Level level) const { return stats.level >= level; }
+
+    const Stats& getStats() const { return stats; }
+    void resetStats();
+
+    static const char* getLevelName(Level level);
+
+private:
+    void setLevel(Level newLevel);
+
+    Settings settings;
+    Stats stats;
+    bool enabled = true;
+    int framesOverBudget = 0;
+    int framesWithHeadroom = 0;
+    double lastFrameMs = 0.0;
+};
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <juce_gui_extra/juce_gui_extra.h>
+
+// Sends synthetic mouse events straight to a component, with positions given
+// relative to its size. Used by the offline tools to drive the XY pad without
+// a window or a real pointer.
+class ScriptedMouse
+{
+public:
+    explicit ScriptedMouse(juce::Component& target) : component(target) {}
+
+    void down(float x, float y)
+    {
+        downPosition = toPixels(x, y);
+        component.mouseDown(createEvent(downPosition, 1, false));
+    }
+
+    void drag(float x, float y)     { component.mouseDrag(createEvent(toPixels(x, y), 1, true)); }
+    void up(float x, float y)       { component.mouseUp(createEvent(toPixels(x, y), 1, true)); }
+
+    void doubleClick(float x, float y)
+    {
+        down(x, y);
+        up(x, y);
+        component.mouseDoubleClick(createEvent(toPixels(x, y), 2, false));
+    }
+
+private:
+    juce::Point<float> toPixels(float x, float y) const
+    {
+        return { x * (float)component.getWidth(), y * (float)component.getHeight() };
+    }
+
+    juce::MouseEvent createEvent(juce::Point<float> position, int numClicks, bool wasDragged) const
+    {
+        return juce::MouseEvent(juce::Desktop::getInstance().getMainMouseSource(), position,
+                                juce::ModifierKeys(juce::ModifierKeys::leftButtonModifier),
+                                juce::MouseInputSource::defaultPressure,
+                                juce::MouseInputSource::defaultOrientation,
+                                juce::MouseInputSource::defaultRotation,
+                                juce::MouseInputSource::defaultTiltX,
+                                juce::MouseInputSource::defaultTiltY,
+                                &component, &component, juce::Time(), downPosition, juce::Time(),
+                                numClicks, wasDragged);
+    }
+
+    juce::Component& component;
+    juce::Point<float> downPosition;
+};
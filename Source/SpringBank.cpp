@@ -0,0 +1,166 @@
+#include "SpringBank.h"
+
+SpringBank::SpringBank(std::initializer_list<SpringCoefficients> springs)
+{
+    for (auto& coefficients : springs)
+        add(coefficients);
+}
+
+int SpringBank::add(const SpringCoefficients& coefficients)
+{
+    for (auto* field : { &x, &y, &previousX, &previousY })
+        field->push_back(0.5f);
+
+    for (auto* field : { &vx, &vy, &previousVx, &previousVy })
+        field->push_back(0.0f);
+
+    stiffness.push_back(coefficients.stiffness);
+    damping.push_back(coefficients.damping);
+    mass.push_back(coefficients.mass);
+    slowVelocity.push_back(coefficients.slowVelocity);
+    slowDecay.push_back(coefficients.slowDecay);
+    restVelocity.push_back(coefficients.restVelocity);
+
+    return size() - 1;
+}
+
+SpringCoefficients SpringBank::getCoefficients(int index) const
+{
+    auto i = (size_t)index;
+    return { stiffness[i], damping[i], mass[i], slowVelocity[i], slowDecay[i], restVelocity[i] };
+}
+
+void SpringBank::setCoefficients(int index, const SpringCoefficients& coefficients)
+{
+    auto i = (size_t)index;
+    stiffness[i] = coefficients.stiffness;
+    damping[i] = coefficients.damping;
+    mass[i] = coefficients.mass;
+    slowVelocity[i] = coefficients.slowVelocity;
+    slowDecay[i] = coefficients.slowDecay;
+    restVelocity[i] = coefficients.restVelocity;
+}
+
+void SpringBank::setState(int index, const State& state)
+{
+    auto i = (size_t)index;
+    x[i] = state.x;
+    y[i] = state.y;
+    vx[i] = state.vx;
+    vy[i] = state.vy;
+}
+
+void SpringBank::addVelocity(int index, float dvx, float dvy)
+{
+    vx[(size_t)index] += dvx;
+    vy[(size_t)index] += dvy;
+}
+
+void SpringBank::snapTo(float targetX, float targetY)
+{
+    std::fill(x.begin(), x.end(), targetX);
+    std::fill(y.begin(), y.end(), targetY);
+    std::fill(vx.begin(), vx.end(), 0.0f);
+    std::fill(vy.begin(), vy.end(), 0.0f);
+}
+
+// One axis of SpringBank::step(). The arrays never overlap, and saying so (which
+// only counts for parameters) lets the compiler vectorise without checking. Selects
+// rather than ifs, with every value loaded up front, keep it one vectorised loop.
+static void stepAxis(float* __restrict position, float* __restrict velocity,
+                     const float* __restrict stiffness, const float* __restrict damping, const float* __restrict mass,
+                     const float* __restrict slowVelocity, const float* __restrict slowDecay,
+                     const float* __restrict restVelocity, int begin, int end, float target, float dt)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        float acceleration = ((target - position[i]) * stiffness[i] - velocity[i] * damping[i]) / mass[i];
+        float newVelocity = velocity[i] + acceleration * dt;
+
+        position[i] += newVelocity * dt;
+
+        float slowBelow = slowVelocity[i], slowFactor = slowDecay[i], restBelow = restVelocity[i];
+        newVelocity *= std::abs(newVelocity) < slowBelow ? slowFactor : 1.0f;
+        velocity[i] = std::abs(newVelocity) < restBelow ? 0.0f : newVelocity;
+    }
+}
+
+void SpringBank::step(int begin, int end, float targetX, float targetY, float dt)
+{
+    jassert(0 <= begin && begin <= end && end <= size());
+
+    stepAxis(x.data(), vx.data(), stiffness.data(), damping.data(), mass.data(),
+             slowVelocity.data(), slowDecay.data(), restVelocity.data(), begin, end, targetX, dt);
+    stepAxis(y.data(), vy.data(), stiffness.data(), damping.data(), mass.data(),
+             slowVelocity.data(), slowDecay.data(), restVelocity.data(), begin, end, targetY, dt);
+}
+
+float SpringBank::getTotalSpeed(int begin, int end) const
+{
+    float total = 0.0f;
+
+    for (int i = begin; i < end; ++i)
+        total += std::abs(vx[(size_t)i]) + std::abs(vy[(size_t)i]);
+
+    return total;
+}
+
+void SpringBank::storePreviousStates()
+{
+    previousX = x;
+    previousY = y;
+    previousVx = vx;
+    previousVy = vy;
+}
+
+SpringBank::State SpringBank::getInterpolatedState(int index, float proportionOfStep) const
+{
+    auto i = (size_t)index;
+    auto t = proportionOfStep;
+
+    return { previousX[i] + (x[i] - previousX[i]) * t, previousY[i] + (y[i] - previousY[i]) * t,
+             previousVx[i] + (vx[i] - previousVx[i]) * t, previousVy[i] + (vy[i] - previousVy[i]) * t };
+}
+
+float SpringBank::getDecayRate(int index) const
+{
+    auto i = (size_t)index;
+    float discriminant = damping[i] * damping[i] - 4.0f * mass[i] * stiffness[i];
+
+    if (discriminant < 0.0f)
+        return damping[i] / (2.0f * mass[i]);  // Underdamped: envelope decay
+
+    return (damping[i] - std::sqrt(discriminant)) / (2.0f * mass[i]);
+}
+
+float SpringBank::predictFramesToSettle(int index, float targetX, float targetY,
+                                        float positionTolerance, float velocityTolerance) const
+{
+    auto i = (size_t)index;
+    float rate = getDecayRate(index);
+
+    float offset = juce::jmax(std::abs(x[i] - targetX), std::abs(y[i] - targetY));
+    float speed = juce::jmax(std::abs(vx[i]), std::abs(vy[i]));
+    float accel = juce::jmax(std::abs(((targetX - x[i]) * stiffness[i] - vx[i] * damping[i]) / mass[i]),
+                             std::abs(((targetY - y[i]) * stiffness[i] - vy[i] * damping[i]) / mass[i]));
+
+    return juce::jmax(framesUntilBelow(offset, speed + rate * offset, rate, positionTolerance),
+                      framesUntilBelow(speed, accel + rate * speed, rate, velocityTolerance));
+}
+
+float SpringBank::framesUntilBelow(float a, float b, float rate, float tolerance)
+{
+    // The envelope peaks at t = 1/rate - a/b, or at t = 0 when that is negative
+    float peakTime = b > 0.0f ? juce::jmax(0.0f, 1.0f / rate - a / b) : 0.0f;
+
+    if ((a + b * peakTime) * std::exp(-rate * peakTime) <= tolerance)
+        return 0.0f;
+
+    // Fixed-point iteration, which contracts from just past the peak
+    float t = peakTime + 1.0f / rate;
+
+    for (int i = 0; i < 10; ++i)
+        t = std::log((a + b * t) / tolerance) / rate;
+
+    return juce::jmax(0.0f, t);
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <initializer_list>
+#include <vector>
+
+// One damped spring's constants. The last three let a spring's final creep die
+// away: below slowVelocity its velocity shrinks by slowDecay every step, and
+// below restVelocity it's zeroed. The defaults leave the creep alone.
+struct SpringCoefficients
+{
+    float stiffness = 0.05f;
+    float damping = 0.8f;
+    float mass = 5.0f;
+    float slowVelocity = 0.0f;
+    float slowDecay = 1.0f;
+    float restVelocity = 0.0f;
+};
+
+// The pad's cursor spring: overdamped, so it never bounces. XYModulation's
+// PadSpring smoothing uses it too, so the audio follows the cursor as drawn.
+inline constexpr SpringCoefficients cursorSpring { 0.20f, 1.13f, 1.6f };
+
+// Any number of 2D springs, stored as one array per field rather than one
+// struct per spring. A step runs down each array with no branches, so the
+// compiler vectorises it and a stack of 32 layers costs little more than 6.
+//
+// The bank also keeps every spring's state from before the latest step, so
+// frames that fall between steps can draw the springs in between.
+class SpringBank
+{
+public:
+    struct State
+    {
+        float x, y;
+        float vx, vy;
+    };
+
+    SpringBank() = default;
+    SpringBank(std::initializer_list<SpringCoefficients> springs);
+
+    // Adds a spring at rest at (0.5, 0.5) and returns its index
+    int add(const SpringCoefficients& coefficients);
+    int size() const { return (int)x.size(); }
+
+    SpringCoefficients getCoefficients(int index) const;
+    void setCoefficients(int index, const SpringCoefficients& coefficients);
+
+    State getState(int index) const { return { x[(size_t)index], y[(size_t)index], vx[(size_t)index], vy[(size_t)index] }; }
+    void setState(int index, const State& state);
+    void addVelocity(int index, float dvx, float dvy);
+
+    // Puts every spring at rest at one point
+    void snapTo(float targetX, float targetY);
+
+    // One semi-implicit Euler step of dt frames for springs [begin, end), which
+    // all chase the same point
+    void step(int begin, int end, float targetX, float targetY, float dt = 1.0f);
+
+    // Sum of |vx| + |vy| over springs [begin, end)
+    float getTotalSpeed(int begin, int end) const;
+
+    // Call before step() to keep the states it starts from, so that frames can
+    // draw the springs part of the way through the step
+    void storePreviousStates();
+    State getInterpolatedState(int index, float proportionOfStep) const;
+
+    // Slowest decay rate (per frame) of the damped spring, taken from the
+    // roots of m*s^2 + c*s + k = 0
+    float getDecayRate(int index) const;
+
+    // Frames until both offset from the target and velocity stay below their
+    // tolerances, using the envelope bound |x(t)| <= (a + b*t) * e^(-rate*t)
+    float predictFramesToSettle(int index, float targetX, float targetY,
+                                float positionTolerance, float velocityTolerance) const;
+
+private:
+    static float framesUntilBelow(float a, float b, float rate, float tolerance);
+
+    std::vector<float> x, y, vx, vy;
+    std::vector<float> previousX, previousY, previousVx, previousVy;
+    std::vector<float> stiffness, damping, mass, slowVelocity, slowDecay, restVelocity;
+
+    JUCE_LEAK_DETECTOR(SpringBank)
+};
@@ -0,0 +1,136 @@
+#include "TileRenderPool.h"
+
+class TileRenderPool::Worker : public juce::Thread
+{
+public:
+    Worker(TileRenderPool& ownerPool, int index)
+        : juce::Thread("Tile renderer " + juce::String(index)),
+          owner(ownerPool),
+          queueIndex(index)
+    {
+    }
+
+    void run() override
+    {
+        for (;;)
+        {
+            wait(-1);
+
+            if (threadShouldExit())
+                return;
+
+            owner.processTiles(queueIndex);
+
+            if (owner.workersBusy.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                owner.workersFinished.signal();
+        }
+    }
+
+private:
+    TileRenderPool& owner;
+    const int queueIndex;
+};
+
+//==============================================================================
+TileRenderPool::TileRenderPool()
+    : TileRenderPool(getDefaultNumWorkers())
+{
+}
+
+TileRenderPool::TileRenderPool(int numWorkers)
+    : queues(std::make_unique<Queue[]>((size_t)juce::jmax(0, numWorkers) + 1))
+{
+    // Queue 0 belongs to the calling thread, queue i to worker i
+    for (int i = 1; i <= numWorkers; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(*this, i));
+        workers.back()->startThread(juce::Thread::Priority::high);
+    }
+}
+
+TileRenderPool::~TileRenderPool()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        worker->notify();
+        worker->stopThread(1000);
+    }
+}
+
+int TileRenderPool::getDefaultNumWorkers()
+{
+    return juce::jlimit(0, 7, juce::SystemStats::getNumCpus() - 1);
+}
+
+void TileRenderPool::run(int numTiles, const std::function<void(int)>& renderTile)
+{
+    if (numTiles <= 0)
+        return;
+
+    // Not worth waking anyone for
+    if (numTiles == 1 || workers.empty())
+    {
+        for (int i = 0; i < numTiles; ++i)
+            renderTile(i);
+
+        return;
+    }
+
+    // Deal the tiles out as evenly sized contiguous runs
+    const int numQueues = getNumThreads();
+
+    for (int i = 0; i < numQueues; ++i)
+    {
+        queues[(size_t)i].next.store(numTiles * i / numQueues, std::memory_order_relaxed);
+        queues[(size_t)i].end = numTiles * (i + 1) / numQueues;
+    }
+
+    currentTask = &renderTile;
+    workersFinished.reset();
+
+    // Publishes the queues and task to the workers
+    workersBusy.store((int)workers.size(), std::memory_order_release);
+
+    for (auto& worker : workers)
+        worker->notify();
+
+    processTiles(0);
+
+    // Every worker must have let go of the task before it goes out of scope.
+    // The last worker of the previous frame may only signal after this frame's
+    // reset(), so a wake-up alone proves nothing: check the count again.
+    while (workersBusy.load(std::memory_order_acquire) > 0)
+        workersFinished.wait(-1);
+
+    currentTask = nullptr;
+}
+
+void TileRenderPool::processTiles(int queueIndex)
+{
+    const int numQueues = getNumThreads();
+    int tileIndex;
+
+    // Own run first, then steal from the others, starting with the neighbour
+    for (int offset = 0; offset < numQueues; ++offset)
+    {
+        const int victim = (queueIndex + offset) % numQueues;
+
+        while (claimTile(victim, tileIndex))
+            (*currentTask)(tileIndex);
+    }
+}
+
+bool TileRenderPool::claimTile(int queueIndex, int& tileIndex)
+{
+    auto& queue = queues[(size_t)queueIndex];
+
+    // Cheap check first, so exhausted queues aren't hammered with increments
+    if (queue.next.load(std::memory_order_relaxed) >= queue.end)
+        return false;
+
+    tileIndex = queue.next.fetch_add(1, std::memory_order_relaxed);
+    return tileIndex < queue.end;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// A small, persistent pool of render threads for splitting one frame into
+// tiles. The threads are started once and sleep between frames, so a frame
+// costs a wake-up rather than a thread or job allocation.
+//
+// Each participating thread (the workers plus the caller of run()) is dealt a
+// contiguous run of tiles, which keeps neighbouring tiles on the same core.
+// A thread that finishes its own run steals the remaining tiles from the
+// others, so uneven tiles (a dense glow centre next to empty background)
+// still balance out.
+//
+// Shared through juce::SharedResourcePointer, so every pad in the process
+// uses the same threads.
+class TileRenderPool
+{
+public:
+    TileRenderPool();
+    explicit TileRenderPool(int numWorkers);
+    ~TileRenderPool();
+
+    // One fewer than the hardware threads (the caller renders too), at most 7
+    static int getDefaultNumWorkers();
+
+    int getNumThreads() const { return (int)workers.size() + 1; }
+
+    // Calls renderTile for every index in [0, numTiles) across the pool and
+    // the calling thread, and returns once all of them have finished. Tiles
+    // must be independent of each other. Not reentrant: call from one thread.
+    void run(int numTiles, const std::function<void(int tileIndex)>& renderTile);
+
+private:
+    class Worker;
+
+    // One thread's run of tiles: [next, end) are still to be claimed. Owner and
+    // thieves all claim with an atomic increment, so no tile is done twice.
+    struct alignas(64) Queue
+    {
+        std::atomic<int> next { 0 };
+        int end = 0;
+    };
+
+    void processTiles(int queueIndex);
+    bool claimTile(int queueIndex, int& tileIndex);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::unique_ptr<Queue[]> queues;
+    const std::function<void(int)>* currentTask = nullptr;
+
+    std::atomic<int> workersBusy { 0 };
+    juce::WaitableEvent workersFinished;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TileRenderPool)
+};
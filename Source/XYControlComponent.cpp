@@ -1,28 +1,46 @@
 #include "XYControlComponent.h"
 #include "BinaryData.h"
+#include "GlowAssetPack.h"
+#include "GlowRasterizer.h"
+
+// The glow layers trail the cursor, and let their last creep die away gradually
+// (only once it's tiny, so nothing snaps) rather than drifting on
+static SpringCoefficients glowSpring(float stiffness, float damping, float mass)
+{
+    return { stiffness, damping, mass, 0.0005f, 0.98f, 0.00001f };
+}
 
 XYControlComponent::XYControlComponent()
-    : springLayers{{
-        SpringLayer(0.20f, 1.13f, 1.6f),    // cursor - overdamped, zero bounce
-        SpringLayer(0.09f, 0.88f, 3.8f),    // inner
-        SpringLayer(0.07f, 0.85f, 5.2f),    // mid
-        SpringLayer(0.05f, 0.82f, 6.8f),    // outer
-        SpringLayer(0.04f, 0.78f, 8.5f),    // ambient
-        SpringLayer(0.03f, 0.75f, 10.5f)    // atmosphere
-    }},
-    glowLayers{{
-        {120, 0.95f, juce::Colours::black, {}},  // Will be set by preset
-        {180, 0.75f, juce::Colours::black, {}},
-        {260, 0.60f, juce::Colours::black, {}},
-        {360, 0.45f, juce::Colours::black, {}},
-        {480, 0.35f, juce::Colours::black, {}}
-    }}
-{
-    lastFrameTime = juce::Time::currentTimeMillis();
-    startTimerHz(60);
-
-    updateColorsForPreset();
-    loadGlowImagesFromBinaryData();
+    : springs {
+        cursorSpring,                       // cursor - overdamped, zero bounce
+        glowSpring(0.09f, 0.88f, 3.8f),     // inner
+        glowSpring(0.07f, 0.85f, 5.2f),     // mid
+        glowSpring(0.05f, 0.82f, 6.8f),     // outer
+        glowSpring(0.04f, 0.78f, 8.5f),     // ambient
+        glowSpring(0.03f, 0.75f, 10.5f)     // atmosphere
+    }
+{
+    frameClock.onFrame = [this](double elapsedMs)
+    {
+        // Vblanks stop for a minimised window, but the fallback timer doesn't
+        if (!isShowing())
+            return updateSuspension();
+
+        if (isBreathingPaused())
+            return updateFrameClock();
+
+        frameClockTimeMs = FrameClock::getTimeMs();
+        advanceAnimation((float)(elapsedMs / 16.67));
+    };
+
+    resetSpringInterpolation();
+
+    // Starts the frame clock once the pad is on screen
+    updateSuspension();
+
+    // Glow images (or profiles) are created on first paint, once we know which are needed
+    theme = getPresetTheme(currentPreset);
+    updateColorsForTheme();
 }
 
 XYControlComponent::~XYControlComponent()
@@ -32,253 +50,1273 @@ XYControlComponent::~XYControlComponent()
 void XYControlComponent::setPreset(Preset preset)
 {
     currentPreset = preset;
-    updateColorsForPreset();
-    loadGlowImagesFromBinaryData();
+    setTheme(getPresetTheme(preset));
+}
+
+void XYControlComponent::setTheme(const GlowTheme& newTheme)
+{
+    theme = newTheme;
+
+    // Colours are applied while compositing, so they change right away. Glow
+    // masks of other sizes are swapped in on the next paint if they were
+    // prefetched, or once the loader thread has them; until then the current
+    // masks stay up.
+    updateColorsForTheme();
+    lastFrameArea = {};
     repaint();
+    wakeAnimation();
+
+    if (onThemeChanged != nullptr)
+        onThemeChanged();
+}
+
+void XYControlComponent::setUnderlay(const juce::Image& image, const juce::AffineTransform& imageToPad)
+{
+    underlay = image;
+    underlayTransform = imageToPad;
+    setOpaque(underlay.isValid());
+    repaint();
+}
+
+void XYControlComponent::setPosition(float x, float y)
+{
+    targetX = inputX = x;
+    targetY = inputY = y;
+    publishedPosition = { x, y };
+    pointerInput.clear();
+    auto cursor = springs.getState(0);
+    springs.setState(0, { x, y, cursor.vx, cursor.vy });
+    resetSpringInterpolation();
+    wakeAnimation();
+}
+
+void XYControlComponent::setTargetPosition(float x, float y)
+{
+    targetX = inputX = x;
+    targetY = inputY = y;
+    publishedPosition = { x, y };
+    pointerInput.clear();
+    wakeAnimation();
+}
+
+void XYControlComponent::setIdleBreathingRate(int framesPerSecond)
+{
+    idleBreathingRate = juce::jlimit(0, 60, framesPerSecond);
+
+    // Re-enter the idle state so the new rate takes effect straight away
+    if (animationState != AnimationState::Active)
+        wakeAnimation();
 }
 
-void XYControlComponent::updateColorsForPreset()
+int XYControlComponent::getBreathingFrameRate() const
 {
-    switch (currentPreset)
+    if (qualityGovernor.isAtLeast(QualityGovernor::Level::SlowBreathing))
+        return juce::jmax(1, idleBreathingRate / 2);
+
+    return idleBreathingRate;
+}
+
+void XYControlComponent::wakeAnimation()
+{
+    if (animationState == AnimationState::Active)
+        return;
+
+    // Don't let the time spent asleep turn into one huge step
+    frameClock.resetTime();
+
+    if (frameClockTimeMs >= 0.0)
+        frameClockTimeMs = FrameClock::getTimeMs();
+
+    setAnimationState(AnimationState::Active);
+}
+
+void XYControlComponent::setAnimationState(AnimationState newState)
+{
+    if (newState == animationState)
+        return;
+
+    bool wasAnimating = isAnimating();
+    animationState = newState;
+
+    updateFrameClock();
+
+    // Idle time is a good moment to decode the preset the user is likely to pick next
+    if (animationState != AnimationState::Active)
+        prefetchNextPreset();
+
+    if (wasAnimating != isAnimating() && onAnimationStateChanged != nullptr)
+        onAnimationStateChanged(isAnimating());
+}
+
+void XYControlComponent::updateFrameClock()
+{
+    bool breathingPaused = isBreathingPaused();
+
+    if (suspended || animationState == AnimationState::Asleep || breathingPaused)
+        frameClock.stop();
+    else
+        frameClock.start(animationState == AnimationState::Breathing ? getBreathingFrameRate() : 0);
+
+    // Plugins aren't told when the host comes back to the front, so look now and then
+    if (breathingPaused && !suspended)
+        foregroundCheck.startTimer(foregroundCheckIntervalMs);
+    else
+        foregroundCheck.stopTimer();
+}
+
+bool XYControlComponent::isBreathingPaused() const
+{
+    // Nobody is watching the idle glow while the host is in the background
+    return animationState == AnimationState::Breathing && !juce::Process::isForegroundProcess();
+}
+
+void XYControlComponent::updateSuspension()
+{
+    bool shouldSuspend = !isShowing();
+
+    if (shouldSuspend == suspended)
+        return;
+
+    bool wasAnimating = isAnimating();
+    suspended = shouldSuspend;
+
+    if (suspended)
+        suspendedAtMs = FrameClock::getTimeMs();
+
+    updateFrameClock();
+
+    if (wasAnimating != isAnimating() && onAnimationStateChanged != nullptr)
+        onAnimationStateChanged(isAnimating());
+
+    // Pick up where the animation would be by now, rather than playing out the time away
+    if (!suspended && suspendedAtMs > 0.0)
+        fastForwardAnimation(FrameClock::getTimeMs() - suspendedAtMs);
+}
+
+void XYControlComponent::fastForwardAnimation(double elapsedMs)
+{
+    auto elapsedFrames = elapsedMs / 16.67;
+    animationTimeMs += elapsedMs;
+
+    if (frameClockTimeMs >= 0.0)
+        frameClockTimeMs = FrameClock::getTimeMs();
+
+    if (animationState == AnimationState::Active)
     {
-        case Preset::Blue:
-            backgroundColor = juce::Colours::white;
-            cursorColor = juce::Colours::white;
-            break;
+        fastForwardSprings((int)juce::jmin(elapsedFrames + 0.5, (double)std::numeric_limits<int>::max()));
+        resetSpringInterpolation();
+    }
 
-        case Preset::Red:
-            backgroundColor = juce::Colour(0xFFFF0000);  // Red
-            cursorColor = juce::Colour(0xFFFF0000);      // Red
-            break;
+    if (isDispersing)
+        disperseTime += (float)elapsedMs;
 
-        case Preset::Black:
-            backgroundColor = juce::Colours::black;
-            cursorColor = juce::Colours::black;
-            break;
+    if (isBreathing)
+    {
+        // Only the phase matters, so drop the whole breaths
+        breatheTime = (float)std::fmod(breatheTime + 0.025 * elapsedFrames, juce::MathConstants<double>::twoPi);
+        breatheBlend = (float)juce::jmin(1.0, breatheBlend + 0.015 * elapsedFrames);
+    }
+
+    // Settles, schedules the next frame and repaints, without stepping the springs again
+    advanceAnimation(0.0f);
+}
+
+void XYControlComponent::fastForwardSprings(int frames)
+{
+    // A 1-frame step is linear in each spring's offset from the target and its
+    // velocity, and the glow layers chase the cursor, which chases the target.
+    // So one frame is a fixed matrix over all the springs (the same for both axes)
+    // and any number of frames is a power of it, found by repeated squaring. The
+    // damping of tiny velocities is left out; it only acts when everything is
+    // practically at rest.
+    const auto numSprings = (size_t)springs.size();
+    const auto size = numSprings * 2;    // Offset and velocity per spring
+    using Matrix = std::vector<double>;  // Row-major
+
+    auto step = [&](std::vector<double>& state)
+    {
+        for (size_t i = 0; i < numSprings; ++i)
+        {
+            auto spring = springs.getCoefficients((int)i);
+            double target = i == 0 ? 0.0 : state[0];    // The cursor's new position
+            auto& offset = state[i * 2];
+            auto& velocity = state[i * 2 + 1];
+
+            velocity += ((target - offset) * spring.stiffness - velocity * spring.damping) / spring.mass;
+            offset += velocity;
+        }
+    };
+
+    auto multiply = [size](const Matrix& a, const Matrix& b)
+    {
+        Matrix product(size * size, 0.0);
+
+        for (size_t row = 0; row < size; ++row)
+            for (size_t k = 0; k < size; ++k)
+                for (size_t column = 0; column < size; ++column)
+                    product[row * size + column] += a[row * size + k] * b[k * size + column];
+
+        return product;
+    };
+
+    Matrix frame(size * size, 0.0), result(size * size, 0.0);
+
+    for (size_t column = 0; column < size; ++column)
+    {
+        std::vector<double> unit(size, 0.0);
+        unit[column] = 1.0;
+        step(unit);
+
+        for (size_t row = 0; row < size; ++row)
+            frame[row * size + column] = unit[row];
+
+        result[column * size + column] = 1.0;
+    }
+
+    for (; frames > 0; frames >>= 1)
+    {
+        if ((frames & 1) != 0)
+            result = multiply(result, frame);
+
+        frame = multiply(frame, frame);
+    }
+
+    std::vector<SpringBank::State> states;
+
+    for (size_t i = 0; i < numSprings; ++i)
+        states.push_back(springs.getState((int)i));
+
+    auto advanceAxis = [&](auto position, auto velocity, float target)
+    {
+        std::vector<double> state(size);
+
+        for (size_t i = 0; i < numSprings; ++i)
+        {
+            state[i * 2] = states[i].*position - target;
+            state[i * 2 + 1] = states[i].*velocity;
+        }
+
+        for (size_t i = 0; i < numSprings; ++i)
+        {
+            double newPosition = 0.0, newVelocity = 0.0;
+
+            for (size_t k = 0; k < size; ++k)
+            {
+                newPosition += result[i * 2 * size + k] * state[k];
+                newVelocity += result[(i * 2 + 1) * size + k] * state[k];
+            }
+
+            states[i].*position = (float)newPosition + target;
+            states[i].*velocity = (float)newVelocity;
+        }
+    };
+
+    advanceAxis(&SpringBank::State::x, &SpringBank::State::vx, targetX);
+    advanceAxis(&SpringBank::State::y, &SpringBank::State::vy, targetY);
+
+    for (size_t i = 0; i < numSprings; ++i)
+        springs.setState((int)i, states[i]);
+}
+
+void XYControlComponent::visibilityChanged()
+{
+    updateSuspension();
+}
+
+void XYControlComponent::parentHierarchyChanged()
+{
+    updateSuspension();
+}
+
+void XYControlComponent::updateAnimationSchedule()
+{
+    // Anything under a quarter of a pixel (or the speed at which the comet
+    // deformation becomes invisible) counts as settled
+    float positionTolerance = 0.25f / (float)juce::jmax(1, getWidth());
+    const float velocityTolerance = 0.00005f;
+
+    predictedSettleFrames = springs.predictFramesToSettle(0, targetX, targetY, positionTolerance, velocityTolerance);
+    auto cursor = springs.getState(0);
+
+    for (int i = 1; i < springs.size(); ++i)
+        predictedSettleFrames = juce::jmax(predictedSettleFrames,
+                                           springs.predictFramesToSettle(i, cursor.x, cursor.y,
+                                                                         positionTolerance, velocityTolerance));
+
+    if (predictedSettleFrames > 0.0f || isDragging || isDispersing || pointerInput.hasPending())
+    {
+        setAnimationState(AnimationState::Active);
+        return;
+    }
+
+    // Settled: snap to rest so nothing keeps creeping while we're idle
+    springs.snapTo(targetX, targetY);
+    resetSpringInterpolation();
+
+    if (idleBreathingRate > 0)
+        setAnimationState(AnimationState::Breathing);
+    else if (breatheBlend <= 0.0f)
+        setAnimationState(AnimationState::Asleep);
+}
+
+void XYControlComponent::updateColorsForTheme()
+{
+    backgroundColor = theme.padBackground;
+    cursorColor = theme.cursor;
+
+    for (size_t i = 0; i < glowLayers.size(); ++i)
+    {
+        auto& layer = glowLayers[i];
+        layer.size = theme.glowSizes[i];
+        layer.opacity = GlowRasterizer::layerOpacities[i];
+        layer.color = theme.glowColours[i].withAlpha(1.0f);
+        layer.blurRadius = GlowRasterizer::layerBlurRadii[i];
     }
 }
 
-void XYControlComponent::loadGlowImagesFromBinaryData()
+GlowTheme XYControlComponent::getPresetTheme(Preset preset)
 {
-    // Determine preset prefix and sizes
-    const char* presetName;
-    int sizes[5];
+    GlowTheme presetTheme;
+    presetTheme.glowSizes = { 120, 180, 260, 360, 480 };
 
-    switch (currentPreset)
+    switch (preset)
     {
         case Preset::Blue:
-            presetName = "blue";
-            sizes[0] = 120; sizes[1] = 180; sizes[2] = 260; sizes[3] = 360; sizes[4] = 480;
+            presetTheme.padBackground = juce::Colours::white;
+            presetTheme.cursor = juce::Colours::white;
+            presetTheme.editorBackground = juce::Colours::white;
+            presetTheme.shadow = juce::Colour(0x14000000);  // Subtle dark on white
+            presetTheme.glowColours = {
+                juce::Colour::fromFloatRGBA(0.0f, 0.55f, 1.0f, 1.0f),
+                juce::Colour::fromFloatRGBA(0.0f, 0.57f, 1.0f, 1.0f),
+                juce::Colour::fromFloatRGBA(0.04f, 0.59f, 1.0f, 1.0f),
+                juce::Colour::fromFloatRGBA(0.12f, 0.63f, 1.0f, 1.0f),
+                juce::Colour::fromFloatRGBA(0.20f, 0.69f, 1.0f, 1.0f)
+            };
             break;
+
         case Preset::Red:
-            presetName = "red";
-            sizes[0] = 120; sizes[1] = 180; sizes[2] = 260; sizes[3] = 360; sizes[4] = 480;
+            presetTheme.padBackground = juce::Colour(0xFFFF0000);  // Red
+            presetTheme.cursor = juce::Colour(0xFFFF0000);         // Red
+            presetTheme.editorBackground = juce::Colour(0xFFFF0000);
+            presetTheme.shadow = juce::Colour(0x30000000);  // Darker on red
+            presetTheme.glowColours = {
+                juce::Colour::fromFloatRGBA(1.0f, 0.27f, 0.23f, 1.0f),
+                juce::Colour::fromFloatRGBA(1.0f, 0.29f, 0.25f, 1.0f),
+                juce::Colour::fromFloatRGBA(1.0f, 0.33f, 0.29f, 1.0f),
+                juce::Colour::fromFloatRGBA(1.0f, 0.39f, 0.35f, 1.0f),
+                juce::Colour::fromFloatRGBA(1.0f, 0.47f, 0.43f, 1.0f)
+            };
             break;
+
         case Preset::Black:
-            presetName = "black";
-            // Smaller sizes for white glow to compensate for visual contrast
-            sizes[0] = 100; sizes[1] = 150; sizes[2] = 215; sizes[3] = 300; sizes[4] = 400;
-            break;
-        default:
-            presetName = "blue";
-            sizes[0] = 120; sizes[1] = 180; sizes[2] = 260; sizes[3] = 360; sizes[4] = 480;
+            presetTheme.padBackground = juce::Colours::black;
+            presetTheme.cursor = juce::Colours::black;
+            presetTheme.editorBackground = juce::Colour(0xFF0A0A0A);  // Very dark gray instead of pure black
+            presetTheme.shadow = juce::Colour(0x40000000);  // Barely visible, but keeps the presets uniform
+            presetTheme.glowColours.fill(juce::Colours::white);
+            presetTheme.glowSizes = { 100, 150, 215, 300, 400 };  // Smaller, as a white glow reads larger
             break;
     }
 
-    for (size_t i = 0; i < glowLayers.size(); ++i)
+    return presetTheme;
+}
+
+void XYControlComponent::setProceduralGlowEnabled(bool shouldBeEnabled)
+{
+    if (proceduralGlowEnabled == shouldBeEnabled)
+        return;
+
+    // The resources for the other mode are replaced on the next paint
+    proceduralGlowEnabled = shouldBeEnabled;
+    compositeBuffer = {};
+    repaint();
+}
+
+bool XYControlComponent::isInCurrentRenderMode(const GlowResources& resources) const
+{
+    if (resources.procedural != proceduralGlowEnabled)
+        return false;
+
+    return proceduralGlowEnabled || resources.softwareImages == needsSoftwareGlowImages();
+}
+
+float XYControlComponent::getLayoutScale() const
+{
+    auto size = juce::jmin(getWidth(), getHeight());
+    return size > 0 ? (float)size / designSize : 1.0f;
+}
+
+float XYControlComponent::getWantedPixelScale() const
+{
+    // In steps of 1/16, so a resize by a few pixels doesn't redraw anything; the
+    // remaining resample is within 3% of 1:1, which a blur this soft never shows
+    auto scale = juce::jlimit(0.25f, 4.0f, getLayoutScale() * displayScale);
+    return (float)juce::roundToInt(scale * 16.0f) / 16.0f;
+}
+
+bool XYControlComponent::isAtWantedPixelScale(const GlowResources& resources) const
+{
+    // A procedural glow is evaluated at whatever resolution it's drawn at
+    return resources.procedural || resources.pixelScale == getWantedPixelScale();
+}
+
+void XYControlComponent::ensureGlowResourcesLoaded()
+{
+    adoptLoadedGlowResources();
+
+    // Nothing to show yet, or the render mode changed: there's no old glow to
+    // keep up meanwhile, so take the baked masks right here (from the shared
+    // cache if possible), and draw sharper ones in the background
+    if (glowResources == nullptr || !isInCurrentRenderMode(*glowResources))
     {
-        // Update layer size for current preset
-        glowLayers[i].size = sizes[i];
+        glowResources = createGlowResources(theme.glowSizes, 0.0f, needsSoftwareGlowImages(), proceduralGlowEnabled,
+                                            *glowImageCache);
 
-        // Construct resource name: "glow_blue_layer_0_png"
-        juce::String resourceName = juce::String("glow_") + presetName + "_layer_" + juce::String((int)i) + "_png";
+        if (!isAtWantedPixelScale(*glowResources))
+            loadGlowResourcesInBackground(theme.glowSizes, getWantedPixelScale());
+
+        return;
+    }
 
-        // Get the binary data for this layer
-        int dataSize = 0;
-        const char* data = BinaryData::getNamedResource(resourceName.toRawUTF8(), dataSize);
+    if (glowResources->glowSizes != theme.glowSizes)
+        loadGlowResourcesInBackground(theme.glowSizes, getWantedPixelScale());
+    else if (!isAtWantedPixelScale(*glowResources) && !glowRedrawTimer.isTimerRunning())
+        glowRedrawTimer.startTimer(glowRedrawDelayMs);
+}
+
+void XYControlComponent::redrawGlowForPixelScale()
+{
+    glowRedrawTimer.stopTimer();
 
-        if (data != nullptr && dataSize > 0)
+    // New glow sizes are loaded at the current scale anyway
+    if (glowResources != nullptr && glowResources->glowSizes == theme.glowSizes
+        && !isAtWantedPixelScale(*glowResources))
+        loadGlowResourcesInBackground(theme.glowSizes, getWantedPixelScale());
+}
+
+void XYControlComponent::adoptLoadedGlowResources()
+{
+    if (auto loaded = std::atomic_exchange(loadedGlowResources.get(), GlowResourcesPtr()))
+    {
+        glowLoadInFlight = false;
+        prefetchedGlowResources = loaded;
+    }
+
+    if (prefetchedGlowResources == nullptr || !isInCurrentRenderMode(*prefetchedGlowResources))
+        return;
+
+    if (prefetchedGlowResources->glowSizes != theme.glowSizes)
+        return;
+
+    // Take it if it has the wanted sizes, or draws them sharper than what's shown
+    if (glowResources == nullptr || glowResources->glowSizes != theme.glowSizes
+        || (isAtWantedPixelScale(*prefetchedGlowResources) && !isAtWantedPixelScale(*glowResources)))
+    {
+        glowResources = std::move(prefetchedGlowResources);
+
+        // The glow may change size, so the whole pad needs repainting
+        lastFrameArea = {};
+        repaint();
+    }
+}
+
+void XYControlComponent::loadGlowResourcesInBackground(const GlowSizes& glowSizes, float pixelScale)
+{
+    // One load at a time; whatever is wanted next is requested when it lands
+    if (glowLoadInFlight)
+        return;
+
+    if (prefetchedGlowResources != nullptr && prefetchedGlowResources->glowSizes == glowSizes
+        && prefetchedGlowResources->pixelScale == pixelScale && isInCurrentRenderMode(*prefetchedGlowResources))
+        return;
+
+    glowLoadInFlight = true;
+
+    glowImageLoader->pool.addJob([glowSizes,
+                                  pixelScale,
+                                  softwareImages = needsSoftwareGlowImages(),
+                                  procedural = proceduralGlowEnabled,
+                                  cache = juce::SharedResourcePointer<GlowImageCache>(),
+                                  result = loadedGlowResources,
+                                  safeThis = juce::Component::SafePointer<XYControlComponent>(this)]
+    {
+        auto resources = createGlowResources(glowSizes, pixelScale, softwareImages, procedural, *cache);
+        std::atomic_store(result.get(), resources);
+
+        juce::MessageManager::callAsync([safeThis]
+        {
+            if (auto* pad = safeThis.getComponent())
+            {
+                pad->ensureGlowResourcesLoaded();
+                pad->prefetchNextPreset();
+            }
+        });
+    });
+}
+
+void XYControlComponent::prefetchNextPreset()
+{
+    // Only while idle, so the loading never competes with an animating pad
+    if (animationState == AnimationState::Active || glowResources == nullptr)
+        return;
+
+    // Presets that share glow sizes (blue and red) share masks, so often there's nothing to do
+    auto nextPreset = static_cast<Preset>((static_cast<int>(currentPreset) + 1) % 3);
+    auto nextSizes = getPresetTheme(nextPreset).glowSizes;
+
+    if (nextSizes != glowResources->glowSizes)
+        loadGlowResourcesInBackground(nextSizes, getWantedPixelScale());
+}
+
+juce::Rectangle<float> XYControlComponent::getLayerImageBounds(size_t layerIndex) const
+{
+    auto& layer = glowLayers[layerIndex];
+
+    if (glowResources != nullptr)
+        if (auto& sprites = glowResources->sprites[layerIndex]; sprites != nullptr && !sprites->isEmpty())
+            return sprites->getSourceImage().getBounds().toFloat();
+
+    // The baked image's size: the glow plus its blur margin on each side
+    auto extent = (float)(layer.size + layer.blurRadius * 2);
+    return { extent, extent };
+}
+
+XYControlComponent::GlowResourcesPtr XYControlComponent::createGlowResources(const GlowSizes& glowSizes,
+                                                                             float pixelScale, bool softwareImages,
+                                                                             bool procedural, GlowImageCache& cache)
+{
+    auto resources = std::make_shared<GlowResources>();
+    resources->glowSizes = glowSizes;
+    resources->pixelScale = pixelScale;
+    resources->softwareImages = softwareImages;
+    resources->procedural = procedural;
+
+    bool bakedAtWantedSizes = true;
+
+    for (size_t i = 0; i < resources->sprites.size(); ++i)
+    {
+        if (procedural)
         {
-            // Load PNG from memory
-            glowLayers[i].cachedImage = juce::ImageFileFormat::loadFrom(data, (size_t)dataSize);
+            resources->profiles[i] = ProceduralGlow::createProfile(glowSizes[i], GlowRasterizer::layerBlurRadii[i],
+                                                                    GlowRasterizer::layerOpacities[i]);
+            continue;
         }
-        else
+
+        int glowSize = glowSizes[i];
+
+        if (pixelScale > 0.0f)
         {
-            // Fallback: create a simple colored circle if resource missing
-            juce::Image fallback(juce::Image::ARGB, glowLayers[i].size, glowLayers[i].size, true);
-            juce::Graphics g(fallback);
-            g.setColour(glowLayers[i].color);
-            g.fillEllipse(0, 0, (float)glowLayers[i].size, (float)glowLayers[i].size);
-            glowLayers[i].cachedImage = fallback;
+            // Drawn at the size it's shown at, so it's composited 1:1
+            int pixelSize = juce::roundToInt((float)glowSize * pixelScale);
+            resources->spriteScales[i] = (float)glowSize / (float)pixelSize;
+
+            GlowImageCache::Key key { (int)i, glowSize, pixelScale, softwareImages };
+
+            resources->sprites[i] = cache.getSprites(key, [i, glowSize, pixelScale]
+            {
+                return loadGlowMask((int)i, glowSize, pixelScale);
+            });
+
+            continue;
         }
+
+        // Stand-in: the nearest baked mask, resampled to the wanted size
+        int bakedSize = getGlowLayerPack().findNearestGlowSize((int)i, glowSize);
+
+        if (bakedSize == 0)
+            bakedSize = glowSize;
+
+        bakedAtWantedSizes = bakedAtWantedSizes && bakedSize == glowSize;
+        resources->spriteScales[i] = (float)glowSize / (float)bakedSize;
+
+        // Only the first pad to use a mask loads it; the rest share its sprites
+        GlowImageCache::Key key { (int)i, bakedSize, 1.0f, softwareImages };
+
+        resources->sprites[i] = cache.getSprites(key, [i, bakedSize]
+        {
+            return loadGlowMask((int)i, bakedSize, 1.0f);
+        });
+    }
+
+    // Baked masks of exactly the wanted sizes are what drawing them at 1x would give
+    if (pixelScale <= 0.0f && bakedAtWantedSizes)
+        resources->pixelScale = 1.0f;
+
+    return resources;
+}
+
+const GlowAssetPack& XYControlComponent::getGlowLayerPack()
+{
+    // Raw pixels packed at build time: images taken from it just point at them
+    static const GlowAssetPack pack(BinaryData::glow_layers_bin, (size_t)BinaryData::glow_layers_binSize);
+    return pack;
+}
+
+juce::Image XYControlComponent::loadGlowMask(int layerIndex, int glowSize, float pixelScale)
+{
+    if (pixelScale == 1.0f)
+        if (auto image = getGlowLayerPack().getImage(layerIndex, glowSize); image.isValid())
+            return image;
+
+    // Not in the pack: draw it, the same way the generator does
+    auto scaled = [pixelScale](float size) { return juce::jmax(1, juce::roundToInt(size * pixelScale)); };
+
+    return GlowRasterizer::renderGlowMask(scaled((float)glowSize), GlowRasterizer::layerOpacities[layerIndex],
+                                          scaled((float)GlowRasterizer::layerBlurRadii[layerIndex]));
+}
+
+SpringBank::State XYControlComponent::getRenderedSpring(int index) const
+{
+    // The frame's time falls between the last two physics steps
+    return springs.getInterpolatedState(index, 1.0f - physicsLead);
+}
+
+void XYControlComponent::resetSpringInterpolation()
+{
+    // After the springs were moved outside a physics step, draw them where they are
+    springs.storePreviousStates();
+    physicsLead = 0.0f;
+}
+
+XYControlComponent::LayerRenderState XYControlComponent::getLayerRenderState(int layerIndex, juce::Rectangle<int> bounds) const
+{
+    auto spring = getRenderedSpring(layerIndex + 1);
+    auto& layer = glowLayers[(size_t)layerIndex];
+    const float i = (float)layerIndex;
+    const float layoutScale = getLayoutScale();
+
+    float pixelX = spring.x * bounds.getWidth();
+    float pixelY = spring.y * bounds.getHeight();
+
+    float scaleX = 1.0f;
+    float scaleY = 1.0f;
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float rotation = 0.0f;
+    float opacity = layer.opacity;
+
+    // Calculate velocity magnitude and direction (always, for smooth blending)
+    float speed = std::sqrt(spring.vx * spring.vx + spring.vy * spring.vy);
+
+    // Motion-based deformation
+    if (speed > 0.0001f)
+    {
+        // Angle of movement
+        rotation = std::atan2(spring.vy, spring.vx);
+
+        // Speed-based stretching factor with smooth falloff
+        float speedFactor = 1.0f - std::exp(-speed * 8.0f);
+
+        // Create comet tail effect:
+        // - Stretch along direction of movement (scaleX)
+        // - Squash perpendicular (scaleY)
+        // - More dramatic on outer layers
+        float stretchMultiplier = 1.0f + i * 0.3f;
+        scaleX = 1.0f + speedFactor * (1.2f + stretchMultiplier);  // Stretch behind
+        scaleY = 1.0f / (1.0f + speedFactor * (0.5f + i * 0.1f)); // Squash sides
+
+        // Offset layers backward along movement vector for tail effect
+        float offsetAmount = speedFactor * (15.0f + i * 8.0f) * layoutScale;
+        offsetX = -std::cos(rotation) * offsetAmount;
+        offsetY = -std::sin(rotation) * offsetAmount;
+    }
+
+    // Blend in breathing animation when idle
+    if (isBreathing && breatheBlend > 0.0f)
+    {
+        // Breathing animation with slightly different timing for each layer
+        float breathePhase = breatheTime + i * 0.3f;
+        float breatheScale = 1.0f + 0.08f * std::sin(breathePhase);
+        float breatheOpacity = 0.85f + 0.15f * (0.5f + 0.5f * std::sin(breathePhase));
+
+        // Smoothly blend from motion state to breathing state
+        scaleX = scaleX * (1.0f - breatheBlend) + breatheScale * breatheBlend;
+        scaleY = scaleY * (1.0f - breatheBlend) + breatheScale * breatheBlend;
+        opacity = opacity * (1.0f - breatheBlend) + (layer.opacity * breatheOpacity) * breatheBlend;
+
+        // Fade out motion-based rotation and offset
+        rotation *= (1.0f - breatheBlend);
+        offsetX *= (1.0f - breatheBlend);
+        offsetY *= (1.0f - breatheBlend);
     }
+
+    // Masks are drawn at the size the pad shows them, or resampled to it meanwhile
+    float spriteScale = glowResources != nullptr ? glowResources->spriteScales[(size_t)layerIndex] : 1.0f;
+    spriteScale *= layoutScale;
+
+    LayerRenderState state;
+    state.centre = { pixelX + offsetX, pixelY + offsetY };
+    state.scaleX = scaleX * spriteScale;
+    state.scaleY = scaleY * spriteScale;
+    state.rotation = rotation;
+    state.opacity = opacity;
+
+    return state;
+}
+
+juce::Rectangle<float> XYControlComponent::getCursorBounds(juce::Rectangle<int> bounds) const
+{
+    auto cursor = getRenderedSpring(0);
+    float cursorX = cursor.x * bounds.getWidth();
+    float cursorY = cursor.y * bounds.getHeight();
+    float cursorRadius = (isDragging ? 8.0f : 9.0f) * getLayoutScale();
+
+    return { cursorX - cursorRadius, cursorY - cursorRadius, cursorRadius * 2, cursorRadius * 2 };
 }
 
 void XYControlComponent::paint(juce::Graphics& g)
 {
+    auto paintStart = juce::Time::getHighResolutionTicks();
     auto bounds = getLocalBounds();
 
+    // A minimised window being restored (or a hidden parent being shown) only
+    // shows up as a repaint. Resuming steps the springs and repaints, so it's
+    // left until after this paint; this frame shows where they were.
+    if (suspended && !resumePending)
+    {
+        resumePending = true;
+
+        juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<XYControlComponent>(this)]
+        {
+            if (safeThis != nullptr)
+            {
+                safeThis->resumePending = false;
+                safeThis->updateSuspension();
+            }
+        });
+    }
+
+    // Also changes when the window moves to a display with another scale factor
+    displayScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    ensureGlowResourcesLoaded();
+
+    // An opaque pad paints the parent's pixels outside its rounded corners itself
+    if (underlay.isValid())
+    {
+        g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+        g.drawImageTransformed(underlay, underlayTransform);
+    }
+
+    auto glowStart = juce::Time::getHighResolutionTicks();
+
+    if (needsOffscreenRendering())
+        paintGlowLayersOffscreen(g, bounds);
+    else
+        paintGlowLayers(g, bounds);
+
+    auto glowEnd = juce::Time::getHighResolutionTicks();
+
+    // Draw solid cursor with preset color
+    g.setOpacity(1.0f);
+
+    // Solid cursor circle
+    g.setColour(cursorColor);
+    g.fillEllipse(getCursorBounds(bounds));
+
+    auto paintMs = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - paintStart) * 1000.0;
+
+    if (paintTimingEnabled)
+    {
+        lastPaintTimings.glowMs = juce::Time::highResolutionTicksToSeconds(glowEnd - glowStart) * 1000.0;
+        lastPaintTimings.totalMs = paintMs;
+    }
+
+    if (qualityGovernor.addFrame(paintMs, FrameClock::getTimeMs()))
+        applyQualityLevel();
+
+    // Input to photon: until this paint is done, plus a refresh for it to reach the display
+    if (unshownInputMs > 0.0)
+    {
+        auto latencyMs = FrameClock::getTimeMs() - unshownInputMs + getDisplayLatencyMs();
+        auto& stats = inputLatencyStats;
+
+        ++stats.numSamples;
+        stats.meanMs += (latencyMs - stats.meanMs) / stats.numSamples;
+        stats.maxMs = juce::jmax(stats.maxMs, latencyMs);
+        stats.lastMs = latencyMs;
+        unshownInputMs = 0.0;
+    }
+}
+
+void XYControlComponent::setAdaptiveQualityEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled == qualityGovernor.isEnabled())
+        return;
+
+    auto oldLevel = qualityGovernor.getLevel();
+    qualityGovernor.setEnabled(shouldBeEnabled);
+
+    if (qualityGovernor.getLevel() != oldLevel)
+        applyQualityLevel();
+}
+
+void XYControlComponent::applyQualityLevel()
+{
+    // The number of layers and their sprites may have changed, so the next
+    // frame can't be limited to what moved
+    lastFrameArea = {};
+    repaint();
+    updateFrameClock();
+}
+
+int XYControlComponent::getNumDrawnLayers() const
+{
+    // The outermost layer is the largest and faintest
+    return qualityGovernor.isAtLeast(QualityGovernor::Level::FewerLayers) ? (int)glowLayers.size() - 1
+                                                                          : (int)glowLayers.size();
+}
+
+float XYControlComponent::getSpriteResolution(int layerIndex) const
+{
+    // The outer layers are the widest blurs, so a half-size mip level barely shows
+    if (layerIndex >= 2 && qualityGovernor.isAtLeast(QualityGovernor::Level::HalfResolutionOuter))
+        return 0.5f;
+
+    return 1.0f;
+}
+
+void XYControlComponent::paintGlowLayers(juce::Graphics& g, juce::Rectangle<int> bounds)
+{
     // Draw rounded rectangle background with preset color
     g.setColour(backgroundColor);
-    g.fillRoundedRectangle(bounds.toFloat(), 24.0f);
-
-    // Enable high quality rendering
-    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+    g.fillRoundedRectangle(bounds.toFloat(), getCornerRadius());
 
     // Clip to rounded rectangle
     juce::Path clipPath;
-    clipPath.addRoundedRectangle(bounds.toFloat(), 24.0f);
+    clipPath.addRoundedRectangle(bounds.toFloat(), getCornerRadius());
     g.reduceClipRegion(clipPath);
 
+    lastPaintTimings.layerMs = {};
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
     // Draw glow layers from back to front
-    for (int i = 4; i >= 0; --i)
+    for (int i = getNumDrawnLayers() - 1; i >= 0; --i)
     {
-        auto& spring = springLayers[i + 1];
-        auto& layer = glowLayers[i];
+        auto& sprites = glowResources->sprites[(size_t)i];
+        auto layerStart = juce::Time::getHighResolutionTicks();
+
+        if (sprites == nullptr || sprites->isEmpty())
+            continue;
+
+        // Skip layers that don't touch the area being repainted
+        auto state = getLayerRenderState(i, bounds);
+        auto imageBounds = getLayerImageBounds((size_t)i);
+        if (!g.clipRegionIntersects(imageBounds.transformedBy(state.getTransform(imageBounds))
+                                        .getSmallestIntegerContainer()))
+            continue;
+
+        // Draw from the pre-filtered copy closest to the wanted scale in physical
+        // pixels, so the remaining resample is near 1:1 and bilinear filtering is enough
+        auto resolution = getSpriteResolution(i);
+        auto& sprite = sprites->getSpriteFor(state.scaleX * scale * resolution, state.scaleY * scale * resolution);
+        auto transform = state.getTransform(sprite.image.getBounds().toFloat(), sprite.scaleX, sprite.scaleY);
+
+        bool isPixelAligned = transform.isOnlyTranslation()
+                           && transform.getTranslationX() == std::floor(transform.getTranslationX())
+                           && transform.getTranslationY() == std::floor(transform.getTranslationY());
+
+        bool fastResampling = isPixelAligned || qualityGovernor.isAtLeast(QualityGovernor::Level::FastResampling);
+        g.setImageResamplingQuality(fastResampling ? juce::Graphics::lowResamplingQuality
+                                                   : juce::Graphics::mediumResamplingQuality);
+
+        // Fill the cached blurred mask with the layer's colour, with comet transformation
+        g.setColour(glowLayers[(size_t)i].color);
+        g.setOpacity(state.opacity);
+        g.drawImageTransformed(sprite.image, transform, sprite.image.getFormat() == juce::Image::SingleChannel);
+
+        if (paintTimingEnabled)
+            lastPaintTimings.layerMs[(size_t)i] = juce::Time::highResolutionTicksToSeconds(
+                juce::Time::getHighResolutionTicks() - layerStart) * 1000.0;
+    }
+}
 
-        float pixelX = spring.x * bounds.getWidth();
-        float pixelY = spring.y * bounds.getHeight();
+void XYControlComponent::paintGlowLayersOffscreen(juce::Graphics& g, juce::Rectangle<int> bounds)
+{
+    // Composite at the display's physical resolution so HiDPI stays sharp
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    auto bufferBounds = (bounds.toFloat() * scale).getSmallestIntegerContainer();
 
-        float scaleX = 1.0f;
-        float scaleY = 1.0f;
-        float offsetX = 0.0f;
-        float offsetY = 0.0f;
-        float rotation = 0.0f;
-        float opacity = layer.opacity;
+    if (compositeBuffer.getBounds() != bufferBounds)
+        compositeBuffer = juce::Image(juce::Image::ARGB, bufferBounds.getWidth(), bufferBounds.getHeight(),
+                                      false, juce::SoftwareImageType());
 
-        // Calculate velocity magnitude and direction (always, for smooth blending)
-        float speed = std::sqrt(spring.vx * spring.vx + spring.vy * spring.vy);
+    // Only the area being repainted needs compositing
+    auto area = (g.getClipBounds().toFloat() * scale).getSmallestIntegerContainer().getIntersection(bufferBounds);
 
-        // Motion-based deformation
-        if (speed > 0.0001f)
-        {
-            // Angle of movement
-            rotation = std::atan2(spring.vy, spring.vx);
-
-            // Speed-based stretching factor with smooth falloff
-            float speedFactor = 1.0f - std::exp(-speed * 8.0f);
-
-            // Create comet tail effect:
-            // - Stretch along direction of movement (scaleX)
-            // - Squash perpendicular (scaleY)
-            // - More dramatic on outer layers
-            float stretchMultiplier = 1.0f + i * 0.3f;
-            scaleX = 1.0f + speedFactor * (1.2f + stretchMultiplier);  // Stretch behind
-            scaleY = 1.0f / (1.0f + speedFactor * (0.5f + i * 0.1f)); // Squash sides
-
-            // Offset layers backward along movement vector for tail effect
-            float offsetAmount = speedFactor * (15.0f + i * 8.0f);
-            offsetX = -std::cos(rotation) * offsetAmount;
-            offsetY = -std::sin(rotation) * offsetAmount;
-        }
+    if (proceduralGlowEnabled)
+    {
+        // Back to front; the glow's stretch, squash and rotation go straight into the evaluation
+        std::array<ProceduralGlow::Layer, 5> layers;
+        int numLayers = 0;
 
-        // Blend in breathing animation when idle
-        if (isBreathing && breatheBlend > 0.0f)
+        for (int i = getNumDrawnLayers() - 1; i >= 0; --i)
         {
-            // Breathing animation with slightly different timing for each layer
-            float breathePhase = breatheTime + i * 0.3f;
-            float breatheScale = 1.0f + 0.08f * std::sin(breathePhase);
-            float breatheOpacity = 0.85f + 0.15f * (0.5f + 0.5f * std::sin(breathePhase));
-
-            // Smoothly blend from motion state to breathing state
-            scaleX = scaleX * (1.0f - breatheBlend) + breatheScale * breatheBlend;
-            scaleY = scaleY * (1.0f - breatheBlend) + breatheScale * breatheBlend;
-            opacity = opacity * (1.0f - breatheBlend) + (layer.opacity * breatheOpacity) * breatheBlend;
-
-            // Fade out motion-based rotation and offset
-            rotation *= (1.0f - breatheBlend);
-            offsetX *= (1.0f - breatheBlend);
-            offsetY *= (1.0f - breatheBlend);
+            auto state = getLayerRenderState(i, bounds);
+            auto& layer = layers[(size_t)numLayers++];
+            layer.profile = &glowResources->profiles[(size_t)i];
+            layer.transform = state.getTransform({}).scaled(scale);
+            layer.colour = glowLayers[(size_t)i].color;
+            layer.opacity = state.opacity;
         }
 
-        // Draw the cached blurred image with comet transformation
-        g.setOpacity(opacity);
+        ProceduralGlow::Pass pass(getOffscreenBackend(), compositeBuffer, area,
+                                  layers.data(), numLayers, backgroundColor);
+        renderOffscreenTiles(pass.getArea(), [&pass](juce::Rectangle<int> tile) { pass.render(tile); });
+    }
+    else
+    {
+        std::array<GlowCompositor::Layer, 5> layers;
+        int numLayers = getCompositorLayers(layers, bounds, scale);
 
-        // Create proper directional stretch transform
-        float centerX = layer.cachedImage.getWidth() / 2.0f;
-        float centerY = layer.cachedImage.getHeight() / 2.0f;
+        GlowCompositor::Pass pass(getOffscreenBackend(), compositeBuffer, area,
+                                  layers.data(), numLayers, backgroundColor);
+        renderOffscreenTiles(pass.getArea(), [&pass](juce::Rectangle<int> tile) { pass.render(tile); });
+    }
+
+    // Clip to rounded rectangle
+    juce::Path clipPath;
+    clipPath.addRoundedRectangle(bounds.toFloat(), getCornerRadius());
+    g.reduceClipRegion(clipPath);
 
-        juce::AffineTransform transform = juce::AffineTransform()
-            .translated(-centerX, -centerY)                    // Center at origin
-            .scaled(scaleX, scaleY)                            // Apply scale
-            .followedBy(juce::AffineTransform::rotation(rotation)) // Rotate
-            .translated(pixelX + offsetX, pixelY + offsetY);   // Move to position
+    g.drawImageTransformed(compositeBuffer, juce::AffineTransform::scale(1.0f / scale), false);
+}
 
-        g.drawImageTransformed(layer.cachedImage, transform, false);
+void XYControlComponent::renderOffscreenTiles(juce::Rectangle<int> area,
+                                              const std::function<void(juce::Rectangle<int>)>& renderTile)
+{
+    // The JUCE backend draws through a Graphics context, which can't be shared between threads
+    if (!tiledRenderingEnabled || !tilePool.has_value() || getOffscreenBackend() == GlowCompositor::Backend::Juce
+        || (area.getWidth() <= tileSize && area.getHeight() <= tileSize))
+    {
+        renderTile(area);
+        return;
     }
 
-    // Draw solid cursor with preset color
-    g.setOpacity(1.0f);
+    const int columns = (area.getWidth() + tileSize - 1) / tileSize;
+    const int rows = (area.getHeight() + tileSize - 1) / tileSize;
+
+    // Row-major, so each thread's contiguous run of tiles covers neighbouring memory
+    (*tilePool)->run(columns * rows, [&](int tileIndex)
+    {
+        auto tile = juce::Rectangle<int>(area.getX() + (tileIndex % columns) * tileSize,
+                                         area.getY() + (tileIndex / columns) * tileSize,
+                                         tileSize, tileSize);
+        renderTile(tile.getIntersection(area));
+    });
+}
 
-    float cursorX = springLayers[0].x * bounds.getWidth();
-    float cursorY = springLayers[0].y * bounds.getHeight();
-    float cursorRadius = isDragging ? 8.0f : 9.0f;
+bool XYControlComponent::needsOffscreenRendering() const
+{
+    return compositorBackend != GlowCompositor::Backend::Juce || proceduralGlowEnabled || tiledRenderingEnabled;
+}
 
-    // Solid cursor circle
-    g.setColour(cursorColor);
-    g.fillEllipse(cursorX - cursorRadius, cursorY - cursorRadius,
-                  cursorRadius * 2, cursorRadius * 2);
+bool XYControlComponent::needsSoftwareGlowImages() const
+{
+    return getOffscreenBackend() != GlowCompositor::Backend::Juce;
+}
+
+GlowCompositor::Backend XYControlComponent::getOffscreenBackend() const
+{
+    // Procedural and tiled rendering both need a SIMD kernel
+    if (compositorBackend == GlowCompositor::Backend::Juce && (proceduralGlowEnabled || tiledRenderingEnabled))
+        return GlowCompositor::getBestAvailableBackend();
+
+    return compositorBackend;
+}
+
+int XYControlComponent::getCompositorLayers(std::array<GlowCompositor::Layer, 5>& layers,
+                                            juce::Rectangle<int> bounds, float scale) const
+{
+    int numLayers = 0;
+
+    if (glowResources == nullptr)
+        return numLayers;
+
+    // Back to front, the order they are blended in
+    for (int i = getNumDrawnLayers() - 1; i >= 0; --i)
+    {
+        auto& sprites = glowResources->sprites[(size_t)i];
+
+        if (sprites == nullptr || sprites->isEmpty())
+            continue;
+
+        auto state = getLayerRenderState(i, bounds);
+        auto resolution = getSpriteResolution(i);
+        auto& sprite = sprites->getSpriteFor(state.scaleX * scale * resolution, state.scaleY * scale * resolution);
+
+        auto& compositorLayer = layers[(size_t)numLayers++];
+        compositorLayer.image = sprite.image;
+        compositorLayer.transform = state.getTransform(sprite.image.getBounds().toFloat(), sprite.scaleX, sprite.scaleY)
+                                        .scaled(scale);
+        compositorLayer.opacity = state.opacity;
+        compositorLayer.colour = glowLayers[(size_t)i].color;
+    }
+
+    return numLayers;
+}
+
+void XYControlComponent::setCompositorBackend(GlowCompositor::Backend backend)
+{
+    if (!GlowCompositor::isBackendAvailable(backend))
+        backend = GlowCompositor::Backend::Juce;
+
+    if (backend == compositorBackend)
+        return;
+
+    // Glow images of the other type are swapped in on the next paint
+    compositorBackend = backend;
+    compositeBuffer = {};
+    repaint();
+}
+
+double XYControlComponent::compareCompositorWithJuce() const
+{
+    auto bounds = getLocalBounds();
+
+    std::array<GlowCompositor::Layer, 5> layers;
+    int numLayers = getCompositorLayers(layers, bounds, 1.0f);
+
+    return GlowCompositor::compareWithJuce(compositorBackend, bounds, backgroundColor, layers.data(), numLayers);
+}
+
+void XYControlComponent::setTiledRenderingEnabled(bool shouldBeEnabled)
+{
+    if (tiledRenderingEnabled == shouldBeEnabled)
+        return;
+
+    tiledRenderingEnabled = shouldBeEnabled;
+
+    // Starts the shared worker threads with the first pad that wants them
+    if (tiledRenderingEnabled)
+        tilePool.emplace();
+    else
+        tilePool.reset();
+
+    // Glow images of the other type are swapped in on the next paint
+    compositeBuffer = {};
+    repaint();
+}
+
+void XYControlComponent::setDirtyRegionRepaintEnabled(bool shouldBeEnabled)
+{
+    dirtyRegionRepaintEnabled = shouldBeEnabled;
+    lastFrameArea = {};
+    repaint();
+}
+
+void XYControlComponent::repaintDamagedArea()
+{
+    if (!dirtyRegionRepaintEnabled)
+    {
+        repaint();
+        return;
+    }
+
+    auto bounds = getLocalBounds();
+
+    // Changes smaller than this can't be seen, so they don't count as movement
+    auto isVisuallyEqual = [](const LayerRenderState& a, const LayerRenderState& b)
+    {
+        return std::abs(a.centre.x - b.centre.x) < 0.01f && std::abs(a.centre.y - b.centre.y) < 0.01f
+            && std::abs(a.scaleX - b.scaleX) < 0.0001f && std::abs(a.scaleY - b.scaleY) < 0.0001f
+            && std::abs(a.rotation - b.rotation) < 0.0001f
+            && std::abs(a.opacity - b.opacity) < 1.0f / 512.0f;
+    };
+
+    bool anythingMoved = false;
+    juce::Rectangle<float> frameArea = getCursorBounds(bounds);
+
+    if (frameArea != lastCursorBounds)
+        anythingMoved = true;
+
+    lastCursorBounds = frameArea;
+
+    for (size_t i = 0; i < glowLayers.size(); ++i)
+    {
+        auto state = getLayerRenderState((int)i, bounds);
+
+        if (!isVisuallyEqual(state, lastFrameLayers[i]))
+        {
+            anythingMoved = true;
+            lastFrameLayers[i] = state;
+        }
+
+        auto imageBounds = getLayerImageBounds(i);
+        frameArea = frameArea.getUnion(imageBounds.transformedBy(lastFrameLayers[i].getTransform(imageBounds)));
+    }
+
+    if (!anythingMoved && !lastFrameArea.isEmpty())
+        return;
+
+    // Expand by a pixel to cover anti-aliased edges
+    auto newArea = frameArea.getSmallestIntegerContainer().expanded(1).getIntersection(bounds);
+    auto damagedArea = lastFrameArea.isEmpty() ? newArea : newArea.getUnion(lastFrameArea);
+    lastFrameArea = newArea;
+
+    if (!damagedArea.isEmpty())
+        repaint(damagedArea);
 }
 
 void XYControlComponent::resized()
 {
+    // The whole pad is repainted after a resize, so start damage tracking afresh
+    lastFrameArea = {};
+
+    // Meanwhile the current masks are resampled to the new size
+    if (glowResources != nullptr && !isAtWantedPixelScale(*glowResources))
+        glowRedrawTimer.startTimer(glowRedrawDelayMs);
 }
 
 void XYControlComponent::mouseDown(const juce::MouseEvent& event)
 {
+    wakeAnimation();
+
     // Immediately stop breathing to prevent jitter
     isBreathing = false;
     breatheBlend = 0.0f;
     idleTimer = 0.0f;
     isDragging = true;
 
-    auto bounds = getLocalBounds().toFloat();
-    float newX = event.position.x;
-    float newY = event.position.y;
+    // A press that never ended (e.g. the pad was removed mid-drag) is closed first
+    endGesture();
+    isInGesture = true;
+    listeners.call([this](Listener& l) { l.xyGestureStarted(*this); });
 
-    // Constrain to rounded rectangle
-    constrainToRoundedBounds(newX, newY, bounds.getWidth(), bounds.getHeight(), 24.0f);
-
-    targetX = newX / bounds.getWidth();
-    targetY = newY / bounds.getHeight();
-
-    repaint();
+    addPointerSample(event);
+    publishPosition();
+    repaintDamagedArea();
 }
 
 void XYControlComponent::mouseDrag(const juce::MouseEvent& event)
 {
+    wakeAnimation();
+
     // Ensure breathing is stopped during any drag
     isBreathing = false;
     breatheBlend = 0.0f;
     idleTimer = 0.0f;
 
+    addPointerSample(event);
+    publishPosition();
+    repaintDamagedArea();
+}
+
+void XYControlComponent::addPointerSample(const juce::MouseEvent& event)
+{
     auto bounds = getLocalBounds().toFloat();
     float newX = event.position.x;
     float newY = event.position.y;
 
     // Constrain to rounded rectangle
-    constrainToRoundedBounds(newX, newY, bounds.getWidth(), bounds.getHeight(), 24.0f);
+    constrainToRoundedBounds(newX, newY, bounds.getWidth(), bounds.getHeight(), getCornerRadius());
 
-    targetX = newX / bounds.getWidth();
-    targetY = newY / bounds.getHeight();
+    // The position is reported straight away; the springs take it at the physics
+    // step it arrived in
+    inputX = newX / bounds.getWidth();
+    inputY = newY / bounds.getHeight();
+    pointerInput.push({ inputX, inputY, getInputTimeMs(), FrameClock::getTimeMs() });
+}
 
-    repaint();
+double XYControlComponent::getInputTimeMs() const
+{
+    // Between frames, add how far real time has got since the frame clock's last
+    // frame. Offline tools drive advanceAnimation() themselves, so their samples
+    // land exactly on the step timeline and every run sees the same timestamps.
+    if (frameClockTimeMs < 0.0)
+        return animationTimeMs;
+
+    return animationTimeMs + juce::jlimit(0.0, 16.67, FrameClock::getTimeMs() - frameClockTimeMs);
+}
+
+void XYControlComponent::publishPosition()
+{
+    juce::Point<float> position { inputX, inputY };
+
+    // Pointer events that land on the same spot, e.g. pinned against the edge, aren't edits
+    if (position == publishedPosition)
+        return;
+
+    publishedPosition = position;
+    listeners.call([this, position](Listener& l) { l.xyPositionChanged(*this, position); });
+}
+
+void XYControlComponent::endGesture()
+{
+    if (!isInGesture)
+        return;
+
+    isInGesture = false;
+    listeners.call([this](Listener& l) { l.xyGestureEnded(*this); });
+}
+
+void XYControlComponent::takePointerInput(double stepTimeMs)
+{
+    if (auto sample = pointerInput.popUpTo(stepTimeMs))
+    {
+        targetX = sample->x;
+        targetY = sample->y;
+
+        // Latency is measured from the oldest sample the next paint will show
+        if (unshownInputMs <= 0.0)
+            unshownInputMs = sample->arrivalMs;
+    }
+
+    // Chase where the pointer will be by the time this step reaches the display
+    if (inputPredictionEnabled && isDragging)
+    {
+        auto bounds = getLocalBounds().toFloat();
+        auto predicted = pointerInput.predictPositionAt(stepTimeMs + getDisplayLatencyMs());
+        float newX = predicted.x * bounds.getWidth();
+        float newY = predicted.y * bounds.getHeight();
+
+        constrainToRoundedBounds(newX, newY, bounds.getWidth(), bounds.getHeight(), getCornerRadius());
+
+        targetX = newX / bounds.getWidth();
+        targetY = newY / bounds.getHeight();
+    }
+}
+
+double XYControlComponent::getDisplayLatencyMs() const
+{
+    // A finished frame goes out with the next refresh
+    auto periodMs = frameClock.getStats().vblankPeriodMs;
+    return periodMs > 0.0 ? periodMs : 16.67;
+}
+
+void XYControlComponent::resetInputLatencyStats()
+{
+    inputLatencyStats = {};
+    unshownInputMs = 0.0;
 }
 
 void XYControlComponent::mouseUp(const juce::MouseEvent&)
 {
+    wakeAnimation();
+
     // Don't immediately set isDragging to false - let motion settle first
     // This prevents sudden changes when releasing
     isDragging = false;
 
+    // Settle where the pointer let go, not where it was predicted to go next
+    if (inputPredictionEnabled && !pointerInput.hasPending())
+    {
+        targetX = inputX;
+        targetY = inputY;
+    }
+
+    endGesture();
+
     // Don't reset idle timer - let it accumulate naturally
     // idleTimer will start when velocity drops below threshold
 
-    repaint();
+    repaintDamagedArea();
 }
 
 void XYControlComponent::mouseDoubleClick(const juce::MouseEvent& event)
 {
+    wakeAnimation();
+
     // Trigger disperse effect
     isDispersing = true;
     disperseTime = 0.0f;
@@ -288,9 +1326,9 @@ void XYControlComponent::mouseDoubleClick(const juce::MouseEvent& event)
     // Add radial outward velocity to all glow layers
     // Use golden angle for better distribution
     const float goldenAngle = 2.39996f; // Golden angle in radians
-    float baseAngle = juce::Random::getSystemRandom().nextFloat() * 6.28318f;
+    float baseAngle = random.nextFloat() * 6.28318f;
 
-    for (size_t i = 1; i < springLayers.size(); ++i)
+    for (int i = 1; i < springs.size(); ++i)
     {
         // Use golden angle spiral for natural, even distribution
         float angle = baseAngle + (i - 1) * goldenAngle;
@@ -299,44 +1337,52 @@ void XYControlComponent::mouseDoubleClick(const juce::MouseEvent& event)
 
         // Apply outward impulse - stronger for outer layers
         float impulse = 0.08f + i * 0.025f;
-        springLayers[i].vx += dx * impulse;
-        springLayers[i].vy += dy * impulse;
+        springs.addVelocity(i, dx * impulse, dy * impulse);
     }
 
-    repaint();
+    repaintDamagedArea();
 }
 
-void XYControlComponent::timerCallback()
+void XYControlComponent::advanceAnimation(float elapsedFrames)
 {
-    int64_t currentTime = juce::Time::currentTimeMillis();
-    float dt = juce::jmin((currentTime - lastFrameTime) / 16.67f, 2.0f);
-    lastFrameTime = currentTime;
+    // The springs step at a fixed 60 Hz whatever the frame rate, so the motion is
+    // the same at any refresh rate or load. Physics runs up to a step ahead of the
+    // frame, which draws the springs in between the last two steps.
+    animationTimeMs += elapsedFrames * 16.67;
+    physicsLead -= elapsedFrames;
 
-    // Update all spring layers
-    springLayers[0].update(targetX, targetY, dt);
-
-    for (size_t i = 1; i < springLayers.size(); ++i)
+    if (physicsLead < 0.0f)
     {
-        springLayers[i].update(springLayers[0].x, springLayers[0].y, dt);
+        int steps = (int)std::ceil(-physicsLead);
+        physicsLead += (float)steps;
+
+        // Pointer samples are taken at the step they arrived in
+        auto lastStepMs = animationTimeMs + physicsLead * 16.67;
 
-        // Very gradual velocity decay for smoothest settling
-        // Only decay when extremely small to prevent any snapping
-        if (std::abs(springLayers[i].vx) < 0.0005f)
-            springLayers[i].vx *= 0.98f;  // More gradual
-        if (std::abs(springLayers[i].vy) < 0.0005f)
-            springLayers[i].vy *= 0.98f;
+        // After a long stall, jump most of the way in one go rather than stepping
+        if (steps > maxPhysicsStepsPerFrame)
+        {
+            takePointerInput(lastStepMs - 16.67);
+            fastForwardSprings(steps - 1);
+            steps = 1;
+        }
 
-        // Only fully zero out when microscopic
-        if (std::abs(springLayers[i].vx) < 0.00001f)
-            springLayers[i].vx = 0.0f;
-        if (std::abs(springLayers[i].vy) < 0.00001f)
-            springLayers[i].vy = 0.0f;
+        for (int i = 0; i < steps; ++i)
+        {
+            takePointerInput(lastStepMs - (steps - 1 - i) * 16.67);
+            springs.storePreviousStates();
+            stepSprings();
+        }
     }
 
+    // Idle timing and breathing follow real time, so they keep their speed at the
+    // reduced idle rate
+    float animationDt = juce::jmin(elapsedFrames, 10.0f);
+
     // Update disperse effect
     if (isDispersing)
     {
-        disperseTime += dt * 16.67f;
+        disperseTime += animationDt * 16.67f;
         if (disperseTime > 500.0f)  // Effect lasts ~500ms
         {
             isDispersing = false;
@@ -344,16 +1390,13 @@ void XYControlComponent::timerCallback()
     }
 
     // Check for idle state - use blur layers to determine true stillness
-    float totalVelocity = std::abs(springLayers[0].vx) + std::abs(springLayers[0].vy);
-    float blurVelocity = 0.0f;
-    for (size_t i = 1; i < springLayers.size(); ++i)
-    {
-        blurVelocity += std::abs(springLayers[i].vx) + std::abs(springLayers[i].vy);
-    }
+    float totalVelocity = springs.getTotalSpeed(0, 1);
+    float blurVelocity = springs.getTotalSpeed(1, springs.size());
 
-    if (totalVelocity < 0.001f && blurVelocity < 0.01f && !isDragging && !isDispersing)
+    if (totalVelocity < 0.001f && blurVelocity < 0.01f && !isDragging && !isDispersing
+        && idleBreathingRate > 0)
     {
-        idleTimer += dt * 16.67f;
+        idleTimer += animationDt * 16.67f;
         if (idleTimer > 500.0f)  // Longer delay before breathing starts
         {
             if (!isBreathing)
@@ -374,18 +1417,29 @@ void XYControlComponent::timerCallback()
     // Update breathing animation time and blend
     if (isBreathing)
     {
-        breatheTime += 0.025f;
+        breatheTime += 0.025f * animationDt;
 
         // Smoothly ramp up breathe blend over ~1 second
-        breatheBlend = juce::jmin(1.0f, breatheBlend + 0.015f);
+        breatheBlend = juce::jmin(1.0f, breatheBlend + 0.015f * animationDt);
     }
     else
     {
         // Quickly fade out breathing when motion starts
-        breatheBlend = juce::jmax(0.0f, breatheBlend - 0.08f);
+        breatheBlend = juce::jmax(0.0f, breatheBlend - 0.08f * animationDt);
     }
 
-    repaint();
+    updateAnimationSchedule();
+    repaintDamagedArea();
+}
+
+void XYControlComponent::stepSprings()
+{
+    // Semi-implicit (symplectic) Euler over one 60 Hz frame, well inside its stable
+    // range. The cursor goes first, since the glow layers chase where it's got to.
+    springs.step(0, 1, targetX, targetY);
+
+    auto cursor = springs.getState(0);
+    springs.step(1, springs.size(), cursor.x, cursor.y);
 }
 
 void XYControlComponent::constrainToRoundedBounds(float& x, float& y, float width, float height, float cornerRadius)
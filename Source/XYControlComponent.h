@@ -2,9 +2,22 @@
 
 #include <juce_gui_extra/juce_gui_extra.h>
 #include <array>
+#include <limits>
+#include <optional>
+#include "GlowSpriteCache.h"
+#include "GlowImageCache.h"
+#include "GlowTheme.h"
+#include "GlowCompositor.h"
+#include "ProceduralGlow.h"
+#include "TileRenderPool.h"
+#include "FrameClock.h"
+#include "QualityGovernor.h"
+#include "SpringBank.h"
+#include "PointerInputQueue.h"
 
-class XYControlComponent : public juce::Component,
-                           private juce::Timer
+class GlowAssetPack;
+
+class XYControlComponent : public juce::Component
 {
 public:
     enum class Preset
@@ -17,14 +30,169 @@ public:
     XYControlComponent();
     ~XYControlComponent() override;
 
+    // Switches to one of the built-in themes
     void setPreset(Preset preset);
     Preset getCurrentPreset() const { return currentPreset; }
 
-    juce::Point<float> getPosition() const { return juce::Point<float>(targetX, targetY); }
-    void setPosition(float x, float y) { targetX = x; targetY = y; springLayers[0].x = x; springLayers[0].y = y; }
+    // Any colours and glow sizes. Colours apply at once; other glow sizes as
+    // soon as their masks are loaded, with the current ones drawn until then.
+    void setTheme(const GlowTheme& newTheme);
+    const GlowTheme& getTheme() const { return theme; }
+
+    // Called after setTheme() or setPreset(), e.g. for the editor to repaint around the pad
+    std::function<void()> onThemeChanged;
+
+    static GlowTheme getPresetTheme(Preset preset);
+
+    // The latest position from input or setPosition(), which the springs may not have taken yet
+    juce::Point<float> getPosition() const { return juce::Point<float>(inputX, inputY); }
+
+    // Moves the pad without telling listeners, e.g. to follow a host parameter
+    void setPosition(float x, float y);
+
+    // Like setPosition(), but the cursor glides there on its spring rather than
+    // jumping, e.g. while following automation
+    void setTargetPosition(float x, float y);
+
+    // Told about the user's edits as they happen: a gesture brackets each press,
+    // and the position is only reported when it actually changes
+    class Listener
+    {
+    public:
+        virtual ~Listener() = default;
+
+        virtual void xyGestureStarted(XYControlComponent&) {}
+        virtual void xyPositionChanged(XYControlComponent&, juce::Point<float> newPosition) = 0;
+        virtual void xyGestureEnded(XYControlComponent&) {}
+    };
+
+    void addListener(Listener* listener) { listeners.add(listener); }
+    void removeListener(Listener* listener) { listeners.remove(listener); }
+    bool isGestureInProgress() const { return isInGesture; }
+
+    // Pointer samples are queued with their arrival times on the animation's
+    // timeline and handed to the physics at the steps they arrived in. With
+    // prediction on, a drag is extrapolated from the pointer's recent velocity to
+    // where it will be when the frame reaches the display, which hides some of
+    // the springs' lag.
+    void setInputPredictionEnabled(bool shouldBeEnabled) { inputPredictionEnabled = shouldBeEnabled; }
+    bool isInputPredictionEnabled() const { return inputPredictionEnabled; }
+
+    // Time from a pointer sample arriving to the end of the first paint that
+    // shows it, plus a display refresh for that frame to be scanned out
+    struct InputLatencyStats
+    {
+        int numSamples = 0;
+        double meanMs = 0.0;
+        double maxMs = 0.0;
+        double lastMs = 0.0;
+    };
+
+    const InputLatencyStats& getInputLatencyStats() const { return inputLatencyStats; }
+    void resetInputLatencyStats();
+
+    // Once every spring has settled the pad either keeps breathing at this reduced
+    // frame rate, or (with 0) stops its timer until the next input.
+    void setIdleBreathingRate(int framesPerSecond);
+    int getIdleBreathingRate() const { return idleBreathingRate; }
+
+    // Resumes full-rate animation after input, automation or a preset change
+    void wakeAnimation();
+    bool isAnimating() const { return animationState != AnimationState::Asleep && !suspended; }
+
+    // While the pad can't be seen (hidden, taken out of its window, or the window
+    // minimised) its frame clock is stopped, so it costs nothing. When it's back,
+    // the springs jump straight to where they would have got to in the meantime.
+    // The idle breathing also rests while the host is in the background.
+    bool isSuspended() const { return suspended; }
+
+    // Predicted time until all springs come to rest, or 0 if they already have
+    float getPredictedSettleTimeMs() const { return predictedSettleFrames * 16.67f; }
+
+    // Called whenever the pad goes to sleep or wakes up again, or is suspended or resumed
+    std::function<void(bool isAnimating)> onAnimationStateChanged;
+
+    // Advances the animation by a number of 60 Hz frames. The pad's frame clock calls
+    // this with the real elapsed time; offline tools can drive it with a fixed step.
+    // The springs always step by whole frames and are drawn in between, so the
+    // motion doesn't depend on how often this is called.
+    void advanceAnimation(float elapsedFrames);
+
+    // Frame pacing of the display-synced animation clock (missed vblanks, jitter)
+    const FrameClock::Stats& getFramePacingStats() const { return frameClock.getStats(); }
+    void resetFramePacingStats() { frameClock.resetStats(); }
+
+    // Seeds the direction of the double-click disperse, for reproducible runs
+    void setRandomSeed(juce::int64 seed) { random.setSeed(seed); }
+
+    // Time spent in the last paint(). Per-layer times are only measured on the
+    // JUCE path, since the offscreen renderers blend all layers in one pass.
+    struct PaintTimings
+    {
+        std::array<double, 5> layerMs {};   // Indexed like the glow layers (0 = innermost)
+        double glowMs = 0.0;
+        double totalMs = 0.0;
+    };
+
+    void setPaintTimingEnabled(bool shouldBeEnabled) { paintTimingEnabled = shouldBeEnabled; }
+    const PaintTimings& getLastPaintTimings() const { return lastPaintTimings; }
+
+    // Steps the rendering quality down while paints run over the governor's frame
+    // budget, and back up once there's headroom again. On by default; turn it off
+    // for reproducible output and timings.
+    void setAdaptiveQualityEnabled(bool shouldBeEnabled);
+    bool isAdaptiveQualityEnabled() const { return qualityGovernor.isEnabled(); }
+    void setAdaptiveQualitySettings(const QualityGovernor::Settings& settings) { qualityGovernor.setSettings(settings); }
+
+    // The current level and the time spent at each one
+    const QualityGovernor::Stats& getQualityStats() const { return qualityGovernor.getStats(); }
+    void resetQualityStats() { qualityGovernor.resetStats(); }
+
+    // When enabled, each frame repaints only the area touched by the glow layers
+    // and cursor (old and new positions), and skips frames where nothing moved.
+    void setDirtyRegionRepaintEnabled(bool shouldBeEnabled);
+    bool isDirtyRegionRepaintEnabled() const { return dirtyRegionRepaintEnabled; }
+
+    // Selects how the glow layers are blended. The SIMD backends composite all
+    // layers in one pass into an offscreen buffer.
+    void setCompositorBackend(GlowCompositor::Backend backend);
+    GlowCompositor::Backend getCompositorBackend() const { return compositorBackend; }
+
+    // PSNR in dB of the current frame composited by the selected backend
+    // against the same frame drawn through the JUCE path (GoldenImageCheck
+    // runs this for every backend after painting a frame)
+    double compareCompositorWithJuce() const;
+
+    // Evaluates the glow falloff per pixel instead of drawing the baked images,
+    // so no PNG is decoded or kept in memory while this is on
+    void setProceduralGlowEnabled(bool shouldBeEnabled);
+    bool isProceduralGlowEnabled() const { return proceduralGlowEnabled; }
+
+    // Splits the offscreen render into tiles that are composited in parallel on
+    // a worker pool shared by all pads. Tiling needs a SIMD backend, so the best
+    // available one is used while the JUCE backend is selected.
+    void setTiledRenderingEnabled(bool shouldBeEnabled);
+    bool isTiledRenderingEnabled() const { return tiledRenderingEnabled; }
+
+    // The glow sizes, offsets and corner radius are given for a pad this wide, and
+    // scale with the pad. After a resize (or a move to a display with another scale
+    // factor) the glow masks are redrawn in the background at the pad's physical
+    // pixel size, with the baked masks resampled to stand in until they're ready.
+    static constexpr float designSize = 316.0f;
+
+    float getLayoutScale() const;
+    float getCornerRadius() const { return 24.0f * getLayoutScale(); }
+
+    // What the parent draws behind the pad, and the transform from that image to
+    // the pad's coordinates. With one set the pad is opaque and draws its rounded
+    // corners from it, so repainting the pad no longer repaints the parent. An
+    // invalid image makes the pad transparent again.
+    void setUnderlay(const juce::Image& image, const juce::AffineTransform& imageToPad);
 
     void paint(juce::Graphics&) override;
     void resized() override;
+    void visibilityChanged() override;
+    void parentHierarchyChanged() override;
 
     void mouseDown(const juce::MouseEvent& event) override;
     void mouseDrag(const juce::MouseEvent& event) override;
@@ -32,57 +200,84 @@ public:
     void mouseDoubleClick(const juce::MouseEvent& event) override;
 
 private:
-    void timerCallback() override;
 
-    struct SpringLayer
+    struct GlowLayer
     {
-        float x, y;
-        float vx, vy;
-        float stiffness, damping, mass;
-
-        SpringLayer(float stiff, float damp, float m)
-            : x(0.5f), y(0.5f), vx(0), vy(0),
-              stiffness(stiff), damping(damp), mass(m) {}
+        int size = 0;
+        float opacity = 0.0f;
+        juce::Colour color;
+        int blurRadius = 0;
+    };
 
-        void update(float targetX, float targetY, float dt)
-        {
-            // Spring force
-            float fx = (targetX - x) * stiffness;
-            float fy = (targetY - y) * stiffness;
+    using GlowSizes = std::array<int, GlowTheme::numLayers>;
 
-            // Damping force
-            float dampingFx = vx * damping;
-            float dampingFy = vy * damping;
+    // Everything drawn for one set of glow sizes at one resolution in one render
+    // mode (colours are applied while compositing). Created on the loader thread
+    // where possible, and never modified once published.
+    struct GlowResources
+    {
+        GlowSizes glowSizes {};
+        float pixelScale = 0.0f;    // Physical pixels per design pixel the masks were drawn for,
+                                    // or 0 for stand-ins resampled from the nearest baked masks
+        bool softwareImages = false;
+        bool procedural = false;
+        std::array<GlowImageCache::SpritesPtr, 5> sprites;     // Alpha masks, shared with every other pad
+        std::array<float, 5> spriteScales { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };   // Design pixels per mask pixel
+        std::array<ProceduralGlow::Profile, 5> profiles;
+    };
 
-            // Acceleration
-            float ax = (fx - dampingFx) / mass;
-            float ay = (fy - dampingFy) / mass;
+    using GlowResourcesPtr = std::shared_ptr<const GlowResources>;
 
-            // Velocity
-            vx += ax * dt;
-            vy += ay * dt;
+    // Everything needed to draw one glow layer for the current frame
+    struct LayerRenderState
+    {
+        juce::Point<float> centre;
+        float scaleX = 1.0f;
+        float scaleY = 1.0f;
+        float rotation = 0.0f;
+        float opacity = 0.0f;
 
-            // Position
-            x += vx * dt;
-            y += vy * dt;
+        // Places an image centred on the layer, where imageScale is the image's
+        // size relative to the layer's full-size glow image
+        juce::AffineTransform getTransform(juce::Rectangle<float> imageBounds,
+                                           float imageScaleX = 1.0f, float imageScaleY = 1.0f) const
+        {
+            return juce::AffineTransform()
+                .translated(-imageBounds.getWidth() / 2.0f, -imageBounds.getHeight() / 2.0f) // Center at origin
+                .scaled(scaleX / imageScaleX, scaleY / imageScaleY)                         // Apply scale
+                .followedBy(juce::AffineTransform::rotation(rotation))                      // Rotate
+                .translated(centre);                                                        // Move to position
         }
     };
 
-    struct GlowLayer
-    {
-        int size;
-        float opacity;
-        juce::Colour color;
-        juce::Image cachedImage;
-    };
+    // The cursor, then one per glow layer
+    SpringBank springs;
+
+    // How far (in frames) physics has run ahead of the last frame
+    float physicsLead = 0.0f;
+    static constexpr int maxPhysicsStepsPerFrame = 8;
 
-    std::array<SpringLayer, 6> springLayers;
     std::array<GlowLayer, 5> glowLayers;
 
-    float targetX = 0.5f;
+    float targetX = 0.5f;       // Where the springs are heading
     float targetY = 0.5f;
+    float inputX = 0.5f;        // The newest pointer position
+    float inputY = 0.5f;
+    PointerInputQueue pointerInput;
+
+    // The animation's own clock: advanced by advanceAnimation(), and the time
+    // pointer samples are stamped with. frameClockTimeMs is the real time of the
+    // frame clock's last frame, or negative while only offline tools drive the pad.
+    double animationTimeMs = 0.0;
+    double frameClockTimeMs = -1.0;
+    bool inputPredictionEnabled = false;
+    juce::ListenerList<Listener> listeners;
+    juce::Point<float> publishedPosition { 0.5f, 0.5f };    // The last position listeners were told about
+    bool isInGesture = false;
+    double unshownInputMs = 0.0;    // Arrival time of the oldest sample taken since the last paint
+    InputLatencyStats inputLatencyStats;
     bool isDragging = false;
-    int64_t lastFrameTime;
+    FrameClock frameClock { *this };
     float idleTimer = 0.0f;
     bool isBreathing = true;
     float breatheTime = 0.0f;
@@ -90,12 +285,112 @@ private:
     bool isDispersing = false;
     float disperseTime = 0.0f;
 
+    enum class AnimationState
+    {
+        Active,     // Full frame rate while anything is moving
+        Breathing,  // Settled, breathing at the reduced idle rate
+        Asleep      // Settled with breathing disabled, timer stopped
+    };
+
+    AnimationState animationState = AnimationState::Active;
+    int idleBreathingRate = 30;
+    bool suspended = false;
+    bool resumePending = false;     // paint() has posted a look at whether to resume
+    double suspendedAtMs = 0.0;
+
+    static constexpr int foregroundCheckIntervalMs = 500;
+    juce::TimedCallback foregroundCheck { [this] { updateFrameClock(); } };
+    float predictedSettleFrames = 0.0f;
+
+    bool dirtyRegionRepaintEnabled = true;
+    std::array<LayerRenderState, 5> lastFrameLayers;
+    juce::Rectangle<float> lastCursorBounds;
+    juce::Rectangle<int> lastFrameArea;
+
+    GlowCompositor::Backend compositorBackend = GlowCompositor::Backend::Juce;
+    juce::Image compositeBuffer;
+    juce::SharedResourcePointer<GlowImageCache> glowImageCache;
+    juce::SharedResourcePointer<GlowImageLoader> glowImageLoader;
+
+    bool proceduralGlowEnabled = false;
+
+    // What is being drawn, and a finished background load (usually the glow
+    // sizes of the next preset in the cycle) waiting to be adopted. The loader thread hands its
+    // result over through loadedGlowResources with an atomic store.
+    GlowResourcesPtr glowResources;
+    GlowResourcesPtr prefetchedGlowResources;
+    std::shared_ptr<GlowResourcesPtr> loadedGlowResources = std::make_shared<GlowResourcesPtr>();
+    bool glowLoadInFlight = false;
+
+    // Physical pixels per logical pixel, as of the last paint
+    float displayScale = 1.0f;
+
+    // Restarted by every resize, so the masks are only redrawn once the size settles
+    static constexpr int glowRedrawDelayMs = 250;
+    juce::TimedCallback glowRedrawTimer { [this] { redrawGlowForPixelScale(); } };
+
+    static constexpr int tileSize = 128;    // In physical pixels
+    bool tiledRenderingEnabled = false;
+    std::optional<juce::SharedResourcePointer<TileRenderPool>> tilePool;
+
+    juce::Random random;
+    bool paintTimingEnabled = false;
+    PaintTimings lastPaintTimings;
+    QualityGovernor qualityGovernor;
+
+    juce::Image underlay;
+    juce::AffineTransform underlayTransform;
+
     Preset currentPreset = Preset::Blue;
+    GlowTheme theme;
     juce::Colour backgroundColor;
     juce::Colour cursorColor;
 
-    void loadGlowImagesFromBinaryData();
-    void updateColorsForPreset();
+    static GlowResourcesPtr createGlowResources(const GlowSizes& glowSizes, float pixelScale, bool softwareImages,
+                                                bool procedural, GlowImageCache& cache);
+    static const GlowAssetPack& getGlowLayerPack();
+    static juce::Image loadGlowMask(int layerIndex, int glowSize, float pixelScale);
+    bool isInCurrentRenderMode(const GlowResources& resources) const;
+    float getWantedPixelScale() const;
+    bool isAtWantedPixelScale(const GlowResources& resources) const;
+    void ensureGlowResourcesLoaded();
+    void adoptLoadedGlowResources();
+    void loadGlowResourcesInBackground(const GlowSizes& glowSizes, float pixelScale);
+    void redrawGlowForPixelScale();
+    void prefetchNextPreset();
+    juce::Rectangle<float> getLayerImageBounds(size_t layerIndex) const;
+    void paintGlowLayers(juce::Graphics& g, juce::Rectangle<int> bounds);
+    void paintGlowLayersOffscreen(juce::Graphics& g, juce::Rectangle<int> bounds);
+    void renderOffscreenTiles(juce::Rectangle<int> area, const std::function<void(juce::Rectangle<int>)>& renderTile);
+    bool needsOffscreenRendering() const;
+    bool needsSoftwareGlowImages() const;
+    GlowCompositor::Backend getOffscreenBackend() const;
+    int getCompositorLayers(std::array<GlowCompositor::Layer, 5>& layers,
+                            juce::Rectangle<int> bounds, float scale) const;
+    void updateColorsForTheme();
+    void applyQualityLevel();
+    int getBreathingFrameRate() const;
+    int getNumDrawnLayers() const;
+    float getSpriteResolution(int layerIndex) const;
+    LayerRenderState getLayerRenderState(int layerIndex, juce::Rectangle<int> bounds) const;
+    juce::Rectangle<float> getCursorBounds(juce::Rectangle<int> bounds) const;
+    void repaintDamagedArea();
+    void updateAnimationSchedule();
+    void setAnimationState(AnimationState newState);
+    void updateFrameClock();
+    bool isBreathingPaused() const;
+    void updateSuspension();
+    void fastForwardAnimation(double elapsedMs);
+    void fastForwardSprings(int frames);
+    void stepSprings();
+    void addPointerSample(const juce::MouseEvent& event);
+    double getInputTimeMs() const;
+    void takePointerInput(double stepTimeMs);
+    void publishPosition();
+    void endGesture();
+    double getDisplayLatencyMs() const;
+    SpringBank::State getRenderedSpring(int index) const;
+    void resetSpringInterpolation();
     void constrainToRoundedBounds(float& x, float& y, float width, float height, float cornerRadius);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(XYControlComponent)
@@ -0,0 +1,234 @@
+#include "XYModulation.h"
+
+// Both the offset from the target and the velocity are below this, the signal sits on the target
+static constexpr float settledBelow = 1.0e-6f;
+
+void XYModulation::prepare(double newSampleRate, int maximumBlockSize)
+{
+    sampleRate = newSampleRate;
+    buffer.setSize(2, maximumBlockSize);
+    buffer.clear();
+
+    for (auto& power : powers)
+        power.assign((size_t)maximumBlockSize, 0.0f);
+
+    // Long enough for any one step, whose length is rounded either way
+    ramp.resize((size_t)std::ceil(sampleRate / 60.0) + 1);
+
+    for (size_t i = 0; i < ramp.size(); ++i)
+        ramp[i] = (float)i;
+
+    updatePowers();
+    updatePadSpring();
+    padSpringNeedsSync = true;
+}
+
+void XYModulation::reset(float x, float y)
+{
+    axes[0] = { x, 0.0f };
+    axes[1] = { y, 0.0f };
+    padSpringNeedsSync = true;
+}
+
+void XYModulation::syncToTimeline(juce::int64 timeInSamples)
+{
+    if (timeInSamples != samplePosition)
+    {
+        samplePosition = timeInSamples;
+        timelineJumped = true;
+    }
+}
+
+void XYModulation::setSettings(const Settings& newSettings)
+{
+    smoothing = (int)newSettings.smoothing;
+    timeMs = juce::jlimit(0.1f, 1000.0f, newSettings.timeMs);
+    springHz = juce::jlimit(0.1f, 100.0f, newSettings.springHz);
+    springDamping = juce::jlimit(0.1f, 2.0f, newSettings.springDamping);
+    padStiffness = juce::jmax(0.0f, newSettings.padSpring.stiffness);
+    padDamping = juce::jmax(0.0f, newSettings.padSpring.damping);
+    padMass = juce::jmax(0.01f, newSettings.padSpring.mass);
+    settingsChanged = true;
+}
+
+XYModulation::Settings XYModulation::getSettings() const
+{
+    return { (Smoothing)smoothing.load(), timeMs.load(), springHz.load(), springDamping.load(),
+             { padStiffness.load(), padDamping.load(), padMass.load() } };
+}
+
+void XYModulation::updatePadSpring()
+{
+    padSpring.setCoefficients(0, { padStiffness.load(), padDamping.load(), padMass.load() });
+}
+
+void XYModulation::updatePowers()
+{
+    // The one-step matrix acting on (offset from target, velocity)
+    double m00, m01, m10, m11;
+
+    if ((Smoothing)smoothing.load() == Smoothing::OnePole)
+    {
+        m00 = std::exp(-1000.0 / (timeMs.load() * sampleRate));
+        m01 = m10 = m11 = 0.0;
+    }
+    else
+    {
+        // Semi-implicit Euler, one step per sample: v += -k*x - c*v, then x += v
+        auto omega = juce::MathConstants<double>::twoPi * springHz.load() / sampleRate;
+        auto k = omega * omega;
+        auto c = 2.0 * springDamping.load() * omega;
+
+        m00 = 1.0 - k;
+        m01 = 1.0 - c;
+        m10 = -k;
+        m11 = 1.0 - c;
+    }
+
+    // Accumulated in double so long blocks don't drift
+    double p00 = m00, p01 = m01, p10 = m10, p11 = m11;
+
+    for (size_t n = 0; n < powers[0].size(); ++n)
+    {
+        powers[0][n] = (float)p00;
+        powers[1][n] = (float)p01;
+        powers[2][n] = (float)p10;
+        powers[3][n] = (float)p11;
+
+        auto q00 = m00 * p00 + m01 * p10;
+        auto q01 = m00 * p01 + m01 * p11;
+        auto q10 = m10 * p00 + m11 * p10;
+        auto q11 = m10 * p01 + m11 * p11;
+        p00 = q00; p01 = q01; p10 = q10; p11 = q11;
+    }
+}
+
+void XYModulation::process(float targetX, float targetY, int numSamples)
+{
+    // Hosts should stay within the prepared size, but don't write past the buffer if not
+    if (numSamples > buffer.getNumSamples())
+    {
+        jassertfalse;
+        numSamples = buffer.getNumSamples();
+    }
+
+    if (numSamples <= 0)
+        return;
+
+    if (settingsChanged.exchange(false))
+    {
+        updatePowers();
+        updatePadSpring();
+    }
+
+    if (timelineJumped)
+    {
+        reset(targetX, targetY);
+        timelineJumped = false;
+    }
+
+    if ((Smoothing)smoothing.load() == Smoothing::PadSpring)
+    {
+        processPadSpring(targetX, targetY, numSamples);
+    }
+    else
+    {
+        processAxis(axes[0], targetX, buffer.getWritePointer(0), numSamples);
+        processAxis(axes[1], targetY, buffer.getWritePointer(1), numSamples);
+
+        // The pad spring picks up from here if it's switched to
+        padSpringNeedsSync = true;
+    }
+
+    samplePosition += numSamples;
+}
+
+void XYModulation::processAxis(Axis& axis, float target, float* output, int numSamples) const
+{
+    auto offset = axis.value - target;
+    auto velocity = axis.velocity;
+
+    if (std::abs(offset) < settledBelow && std::abs(velocity) < settledBelow)
+    {
+        juce::FloatVectorOperations::fill(output, target, numSamples);
+        axis = { target, 0.0f };
+        return;
+    }
+
+    // output[n] = target + (M^(n + 1) * (offset, velocity)).offset
+    juce::FloatVectorOperations::copyWithMultiply(output, powers[0].data(), offset, numSamples);
+
+    if (velocity != 0.0f)
+        juce::FloatVectorOperations::addWithMultiply(output, powers[1].data(), velocity, numSamples);
+
+    juce::FloatVectorOperations::add(output, target, numSamples);
+
+    auto last = (size_t)numSamples - 1;
+    axis.value = output[last];
+    axis.velocity = powers[2][last] * offset + powers[3][last] * velocity;
+}
+
+juce::int64 XYModulation::getStepStart(juce::int64 step) const
+{
+    // Steps are a 60th of a second apart, rounded up to whole samples
+    return (juce::int64)std::ceil((double)step * sampleRate / 60.0);
+}
+
+void XYModulation::processPadSpring(float targetX, float targetY, int numSamples)
+{
+    if (padSpringNeedsSync)
+    {
+        padSpring.setState(0, { axes[0].value, axes[1].value, 0.0f, 0.0f });
+        padSpring.storePreviousStates();
+
+        // The next step is the first to start now or later
+        nextStep = (juce::int64)((double)samplePosition * 60.0 / sampleRate);
+
+        while (nextStep > 0 && getStepStart(nextStep - 1) >= samplePosition)
+            --nextStep;
+
+        while (getStepStart(nextStep) < samplePosition)
+            ++nextStep;
+
+        padSpringNeedsSync = false;
+    }
+
+    auto* outputX = buffer.getWritePointer(0);
+    auto* outputY = buffer.getWritePointer(1);
+
+    for (int done = 0; done < numSamples;)
+    {
+        auto now = samplePosition + done;
+
+        // Each step chases the target as it is when the step starts, as the pad's
+        // frames do, and the output ramps towards its result over the step
+        if (now == getStepStart(nextStep))
+        {
+            padSpring.storePreviousStates();
+            padSpring.step(0, 1, targetX, targetY);
+            ++nextStep;
+        }
+
+        auto stepStart = getStepStart(nextStep - 1);
+        auto stepEnd = getStepStart(nextStep);
+        auto count = (int)juce::jmin((juce::int64)(numSamples - done), stepEnd - now);
+
+        // Indexed from the step's start, not the block's, so each sample comes out
+        // the same however the steps are split across blocks
+        auto* rampFromStepStart = ramp.data() + (now - stepStart);
+        auto length = (float)(stepEnd - stepStart);
+        auto from = padSpring.getInterpolatedState(0, 0.0f);
+        auto to = padSpring.getState(0);
+
+        juce::FloatVectorOperations::copyWithMultiply(outputX + done, rampFromStepStart, (to.x - from.x) / length, count);
+        juce::FloatVectorOperations::add(outputX + done, from.x, count);
+        juce::FloatVectorOperations::copyWithMultiply(outputY + done, rampFromStepStart, (to.y - from.y) / length, count);
+        juce::FloatVectorOperations::add(outputY + done, from.y, count);
+
+        done += count;
+    }
+
+    // Where the other modes pick up from if they're switched to
+    axes[0] = { outputX[numSamples - 1], 0.0f };
+    axes[1] = { outputY[numSamples - 1], 0.0f };
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "SpringBank.h"
+
+// The pad's X and Y as audio-rate signals, smoothed on the audio thread so
+// they're free of zipper noise whatever the host's automation resolution and
+// whether or not the editor is open. Channel 0 of the buffer is X, channel 1 Y.
+//
+// Over a block the target is fixed, so each smoother is linear in its state:
+// sample n is the target plus the state at the start of the block times the
+// nth power of the smoother's one-step matrix. The powers are tabulated when
+// the settings change, and a block is then a few vectorised multiply-adds
+// per axis rather than a loop that carries state from sample to sample.
+//
+// PadSpring instead runs the pad's own spring model, stepped at the UI's 60 Hz
+// on a grid of the host's timeline and ramped between steps. Where the steps
+// fall and every value between them depend only on the timeline position, so a
+// bounce comes out the same as real-time playback from the same point, at any
+// buffer size, as long as the host delivers the same automation values.
+class XYModulation
+{
+public:
+    enum class Smoothing
+    {
+        OnePole,    // Exponential approach, no overshoot
+        Spring,     // Damped spring, which can overshoot below critical damping
+        PadSpring   // The pad's spring, as the UI draws it
+    };
+
+    struct Settings
+    {
+        Smoothing smoothing = Smoothing::OnePole;
+        float timeMs = 20.0f;           // One-pole time constant
+        float springHz = 4.0f;          // Spring natural frequency
+        float springDamping = 0.7f;     // Spring damping ratio, 1 for critical
+        SpringCoefficients padSpring = cursorSpring;    // Only stiffness, damping and mass are used
+    };
+
+    // Allocates everything, so call before processing starts
+    void prepare(double sampleRate, int maximumBlockSize);
+
+    // Jumps straight to a position with no motion
+    void reset(float x, float y);
+
+    // Where the next block starts on the host's timeline, while it's playing.
+    // A jump from where the last block ended (including the transport starting)
+    // puts the pad spring at rest on its target, so a render starts from the same
+    // state as playback does.
+    void syncToTimeline(juce::int64 timeInSamples);
+
+    // Safe from any thread; the audio thread picks the settings up at its next block
+    void setSettings(const Settings& newSettings);
+    Settings getSettings() const;
+
+    // Fills the buffer's first numSamples with the smoothed signals chasing the target
+    void process(float targetX, float targetY, int numSamples);
+
+    const juce::AudioBuffer<float>& getBuffer() const { return buffer; }
+
+    // The last sample written, on the audio thread's side
+    float getX() const { return axes[0].value; }
+    float getY() const { return axes[1].value; }
+
+private:
+    struct Axis
+    {
+        float value = 0.5f;
+        float velocity = 0.0f;      // Spring only, per sample
+    };
+
+    void updatePowers();
+    void updatePadSpring();
+    void processAxis(Axis& axis, float target, float* output, int numSamples) const;
+    void processPadSpring(float targetX, float targetY, int numSamples);
+    juce::int64 getStepStart(juce::int64 step) const;
+
+    double sampleRate = 44100.0;
+    juce::AudioBuffer<float> buffer;
+    std::array<Axis, 2> axes;
+
+    // Entries of M^(n + 1) for the one-step matrix M, mapping (offset, velocity)
+    // at the start of a block to sample n
+    std::array<std::vector<float>, 4> powers;
+
+    // PadSpring: the spring and where it is on the grid of 60 Hz steps, which
+    // starts at timeline sample 0
+    SpringBank padSpring { SpringCoefficients {} };
+    juce::int64 samplePosition = 0;
+    juce::int64 nextStep = 0;           // Index of the next step, which starts at getStepStart(nextStep)
+    bool padSpringNeedsSync = true;     // Put it at rest where the output is, and find its place on the grid
+    bool timelineJumped = false;
+    std::vector<float> ramp;            // 0, 1, 2... up to a step's length
+
+    std::atomic<int> smoothing { (int)Smoothing::OnePole };
+    std::atomic<float> timeMs { 20.0f };
+    std::atomic<float> springHz { 4.0f };
+    std::atomic<float> springDamping { 0.7f };
+    std::atomic<float> padStiffness { 0.20f };
+    std::atomic<float> padDamping { 1.13f };
+    std::atomic<float> padMass { 1.6f };
+    std::atomic<bool> settingsChanged { true };
+};